@@ -0,0 +1,72 @@
+// AST build / teardown cost and peak heap on a large script
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <string>
+
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+
+static size_t allocations = 0;
+static size_t live = 0;
+static size_t peak = 0;
+
+void* operator new(size_t size){
+  void* p = std::malloc(size);
+  if(!p) throw std::bad_alloc();
+  allocations++;
+  live += malloc_usable_size(p);
+  if(live > peak) peak = live;
+  return p;
+}
+// pairs with the malloc in operator new above
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept {
+  if(p) live -= malloc_usable_size(p);
+  std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+static std::string make_script(int stmts){
+  std::string src;
+  for(int i = 0; i < stmts; i++){
+    src += "mut v" + std::to_string(i) + " = (" + std::to_string(i) +
+           " * 3 + 17) % 7 - (2 + 4) * 5 / 9 + v" + std::to_string(i) + ";\n";
+  }
+  return src;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point t){
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+}
+
+int main(){
+  std::printf("%8s %10s %12s %12s %14s %12s\n",
+              "stmts", "parse ms", "MB/s", "allocs", "peak heap KB", "free ms");
+
+  for(int stmts : {10000, 100000}){
+    auto tok_obj = lexer::new_tokenizer_runtime(make_script(stmts));
+    double mb = tok_obj.source.size() / (1024.0 * 1024.0);
+    parser::parse parsed(std::move(tok_obj));
+
+    size_t base_live = live;
+    peak = live;
+    size_t before = allocations;
+
+    auto begin = std::chrono::steady_clock::now();
+    auto* prog = new parser::program(parsed.make_ast());
+    double parse_ms = ms_since(begin);
+    size_t allocs = allocations - before;
+    size_t peak_kb = (peak - base_live) / 1024;
+
+    begin = std::chrono::steady_clock::now();
+    delete prog;
+    double free_ms = ms_since(begin);
+
+    std::printf("%8d %10.2f %12.1f %12zu %14zu %12.2f\n",
+                stmts, parse_ms, mb / (parse_ms / 1000), allocs, peak_kb, free_ms);
+  }
+  return 0;
+}
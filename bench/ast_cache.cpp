@@ -0,0 +1,117 @@
+// cold start (read, lex, parse, fold, write .meowc) vs warm start (hash the
+// source, map the .meowc, rebuild the AST) on large generated scripts
+// also checks stale and corrupt caches are refused -- exit 1 if not
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include "cache/meowc.hpp"
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "optimizer/optimizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+static std::string make_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\n";
+  for(int i = 0; i < stmts; i++){
+    std::string n = std::to_string(i % 97 + 1);
+    src += "mut a" + std::to_string(i % 500) + " = (a * " + n + " + b) % 13 - (" + n + " + 2) * 3 / 4 + nil;\n";
+  }
+  return src + "a + b\n";
+}
+
+static double ms_since(std::chrono::steady_clock::time_point begin){
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+static parser::program cold(const std::string& script, const std::string& file){
+  auto source = lexer::map_source(script);
+  auto key = cache::make_key(script, source->view(), true);
+  parser::parse parsed{lexer::tokenizer(source)};
+  auto prog = parsed.make_ast();
+  optimizer::optimize(prog);
+  cache::save(prog, key, file);
+  return prog;
+}
+
+static cache::load_status warm(const std::string& script, const std::string& file, parser::program& out){
+  auto source = lexer::map_source(script);
+  auto key = cache::make_key(script, source->view(), true);
+  return cache::load(file, key, out);
+}
+
+static double eval(parser::program& prog){
+  symtable::environment env;
+  resolver::resolve(prog, &env);
+  return interpreter::eval_program(&prog, &env).number;
+}
+
+static int run(int stmts){
+  const std::string script = "/tmp/meow_ast_cache_bench.meow";
+  const std::string file = "/tmp/meow_ast_cache_bench.meowc";
+  const std::string src = make_script(stmts);
+  std::ofstream(script, std::ios::binary) << src;
+  std::remove(file.c_str());
+
+  double cold_ms = 1e30, warm_ms = 1e30;
+  parser::program cold_prog, warm_prog;
+  for(int run = 0; run < 3; run++){
+    auto begin = std::chrono::steady_clock::now();
+    cold_prog = cold(script, file);
+    cold_ms = std::min(cold_ms, ms_since(begin));
+
+    begin = std::chrono::steady_clock::now();
+    warm_prog = parser::program();
+    if(warm(script, file, warm_prog) != cache::load_status::LOADED){
+      std::printf("fresh cache was not loaded\n");
+      return 1;
+    }
+    warm_ms = std::min(warm_ms, ms_since(begin));
+  }
+
+  if(eval(cold_prog) != eval(warm_prog)){
+    std::printf("cached program evaluates differently\n");
+    return 1;
+  }
+
+  std::ifstream in(file, std::ios::binary | std::ios::ate);
+  size_t cache_bytes = static_cast<size_t>(in.tellg());
+  std::printf("%8d %10zu %10zu %10.2f %10.2f %8.1fx\n", stmts, src.size(), cache_bytes,
+              cold_ms, warm_ms, cold_ms / warm_ms);
+
+  // edit the script: the source hash no longer matches
+  std::ofstream(script, std::ios::binary) << src << "a\n";
+  parser::program scratch;
+  auto stale = warm(script, file, scratch);
+
+  // flip one payload byte: the checksum catches it
+  {
+    std::fstream f(file, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(cache_bytes / 2);
+    f.put(static_cast<char>(f.peek() ^ 0x5a));
+  }
+  std::ofstream(script, std::ios::binary) << src;
+  parser::program scratch2;
+  auto corrupt = warm(script, file, scratch2);
+
+  std::remove(script.c_str());
+  std::remove(file.c_str());
+  if(corrupt != cache::load_status::CORRUPT || stale != cache::load_status::STALE){
+    std::printf("damaged cache: %s, edited script: %s\n", cache::load_status_name(corrupt),
+                cache::load_status_name(stale));
+    return 1;
+  }
+  return 0;
+}
+
+int main(){
+  std::printf("%8s %10s %10s %10s %10s %9s\n", "stmts", "src bytes", "meowc", "cold ms", "warm ms", "speedup");
+  for(int stmts : {10000, 100000, 400000}){
+    if(run(stmts)) return 1;
+  }
+  return 0;
+}
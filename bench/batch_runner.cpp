@@ -0,0 +1,105 @@
+// scripts per second: one bin/meow process per script vs one --batch process
+// with 1 and 4 workers. batch output must match the separate runs (exit 1 if not)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+static const char* MEOW = "bin/meow";
+static const int SCRIPTS = 1000;
+
+static std::string make_script(int i){
+  std::string src = "mut a = " + std::to_string(i) + ";\nmut b = a * 3 + 1;\n";
+  for(int j = 0; j < 20; j++) src += "mut b = (b * 7 + a) % 1009;\n";
+  src += i % 50 == 7 ? "missing + b\n" : "b + (a < 3 == true)\n"; // a few fail
+  return src;
+}
+
+// stdout (and stderr) of one command, via the shell
+static std::string capture(const std::string& cmd){
+  std::string out;
+  if(FILE* pipe = popen((cmd + " 2>&1").c_str(), "r")){
+    char buf[4096];
+    for(size_t n; (n = fread(buf, 1, sizeof(buf), pipe)) > 0;) out.append(buf, n);
+    pclose(pipe);
+  }
+  return out;
+}
+
+// fork/exec without a shell in between, output discarded
+static void spawn_quiet(const std::vector<std::string>& args){
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+  std::vector<char*> argv;
+  for(auto& arg : args) argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  if(posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ) == 0){
+    int status;
+    waitpid(pid, &status, 0);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+}
+
+template<class Fn>
+static double seconds(Fn fn){
+  auto begin = std::chrono::steady_clock::now();
+  fn();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(){
+  if(!std::filesystem::exists(MEOW)){
+    std::printf("%s not built, nothing to measure\n", MEOW);
+    return 0;
+  }
+
+  auto dir = std::filesystem::temp_directory_path() / "meow_batch_bench";
+  std::filesystem::create_directories(dir);
+  std::vector<std::string> paths;
+  std::ofstream list(dir / "list");
+  for(int i = 0; i < SCRIPTS; i++){
+    paths.push_back((dir / ("s" + std::to_string(i) + ".meow")).string());
+    std::ofstream(paths.back()) << make_script(i);
+    list << paths.back() << "\n";
+  }
+  list.close();
+  const std::string list_file = (dir / "list").string();
+
+  // same text per script, in order, as running each one by itself
+  std::string expected;
+  for(int i = 0; i < 60; i++) expected += "== " + paths[i] + "\n" + capture(std::string(MEOW) + " " + paths[i]);
+  std::string batch = capture(std::string(MEOW) + " --batch --jobs=4 < " + list_file);
+  if(batch.compare(0, expected.size(), expected) != 0){
+    std::printf("batch output differs from separate runs\n");
+    return 1;
+  }
+
+  double separate = seconds([&]{
+    for(auto& path : paths) spawn_quiet({MEOW, path});
+  });
+  std::printf("%-24s %8.2f s %10.0f scripts/s\n", "process per script", separate, SCRIPTS / separate);
+
+  for(int jobs : {1, 4}){
+    double s = seconds([&]{
+      spawn_quiet({"/bin/sh", "-c", std::string(MEOW) + " --batch --jobs=" + std::to_string(jobs) + " < " + list_file});
+    });
+    std::printf("--batch --jobs=%-9d %8.2f s %10.0f scripts/s %6.1fx\n", jobs, s, SCRIPTS / s, separate / s);
+  }
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
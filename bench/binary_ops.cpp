@@ -0,0 +1,53 @@
+// per operator eval cost of `a OP b` over resolved number variables
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+static const int STMTS = 200000;
+
+static std::string make_script(const std::string& lhs, const char* op, const std::string& rhs){
+  std::string src = "mut a = 7;\nmut b = 3;\nmut n;\nmut s;\n";
+  for(int i = 0; i < STMTS; i++){
+    src += lhs + " " + op + " " + rhs + "\n";
+  }
+  return src;
+}
+
+static void run(const char* label, const std::string& lhs, const char* op, const std::string& rhs){
+  try {
+    parser::parse parsed(lexer::new_tokenizer_runtime(make_script(lhs, op, rhs)));
+    auto prog = parsed.make_ast();
+
+    symtable::environment env;
+    resolver::resolve(prog, &env);
+
+    double ns = 1e30; // best of a few runs, the per op differences are small
+    for(int run = 0; run < 7; run++){
+      auto begin = std::chrono::steady_clock::now();
+      interpreter::eval_program(&prog, &env);
+      auto end = std::chrono::steady_clock::now();
+      ns = std::min(ns, std::chrono::duration<double, std::nano>(end - begin).count() / STMTS);
+    }
+    std::printf("%-14s %-4s %10.1f\n", label, op, ns);
+  } catch(const std::exception&) {
+    std::printf("%-14s %-4s %10s\n", label, op, "n/a");
+  }
+}
+
+int main(){
+  std::printf("%-14s %-4s %10s\n", "operands", "op", "ns/eval");
+
+  for(const char* op : {"+", "-", "*", "/", "%", "==", "!=", "<", "<=", ">", ">=", "and", "or"}){
+    run("number number", "a", op, "b");
+  }
+  for(const char* op : {"+", "=="}){
+    run("nil number", "n", op, "b");
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+// closure tree vs tree walker (vm for reference) on arithmetic and variable heavy scripts
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "closure/closure.hpp"
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+#include "vm/vm.hpp"
+
+static std::string arith_script(int stmts){
+  std::string src;
+  for(int i = 0; i < stmts; i++){
+    std::string n = std::to_string(i % 89 + 1);
+    src += "(" + n + " * 3 + 17) % 7 - (2 + " + n + ") * 5 / 9 + " + n + " * 2 - 1\n";
+  }
+  return src;
+}
+
+static std::string variable_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\nmut c = 5;\nmut d = 6;\n";
+  for(int i = 0; i < stmts; i++){
+    src += "mut d = a + b * c - d + a * b;\n";
+  }
+  return src + "d\n";
+}
+
+static double best_ms(const std::function<void()>& fn){
+  double best = 1e30;
+  for(int run = 0; run < 5; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  return best;
+}
+
+static void compare(const char* name, const std::string& src){
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+
+  // unoptimized on purpose, folding would erase the arithmetic script
+  symtable::environment env;
+  resolver::resolve(prog, &env);
+
+  interpreter::value tree_ret, closure_ret, vm_ret;
+  double tree = best_ms([&]{ tree_ret = interpreter::eval_program(&prog, &env); });
+
+  closure::thunk code;
+  double build = best_ms([&]{ code = closure::compile(prog); });
+  double run = best_ms([&]{ closure_ret = code(&env); });
+
+  auto chunk = vm::compile(prog);
+  double vm_run = best_ms([&]{ vm_ret = vm::run(chunk, &env); });
+
+  std::printf("%-9s %8zu %9.2f %10.2f %11.2f %8.2fx %8.2f\n", name, prog.body.size(),
+              tree, build, run, tree / run, vm_run);
+
+  if(!interpreter::values_equal(tree_ret, closure_ret)) std::printf("  results differ!\n");
+}
+
+int main(){
+  std::printf("%-9s %8s %9s %10s %11s %9s %8s\n",
+              "script", "stmts", "tree ms", "build ms", "closure ms", "speedup", "vm ms");
+  compare("arith", arith_script(200000));
+  compare("variable", variable_script(200000));
+  return 0;
+}
@@ -0,0 +1,71 @@
+// deep expression trees through the tree walker: the success path, and an
+// error raised at the deepest leaf that has to unwind every level
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+// leaf + a + a + ... parses left nested, so leaf is depth levels down
+static std::string chain(const char* leaf, int depth){
+  std::string src = leaf;
+  for(int i = 0; i < depth; i++) src += " + a";
+  return src + "\n";
+}
+
+static double best_us(const std::function<void()>& fn){
+  double best = 1e30;
+  for(int run = 0; run < 7; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::micro>(end - begin).count());
+  }
+  return best;
+}
+
+static void run(int depth, int repeat){
+  symtable::environment env;
+  env.declare_variable(symtable::intern("a"), interpreter::make_number(1));
+
+  parser::parse ok_parse(lexer::new_tokenizer_runtime(chain("a", depth)));
+  auto ok = ok_parse.make_ast();
+  resolver::resolve(ok, &env);
+
+  // `missing` is never declared: the lookup fails at the bottom of the tree
+  parser::parse bad_parse(lexer::new_tokenizer_runtime(chain("missing", depth)));
+  auto bad = bad_parse.make_ast();
+  resolver::resolve(bad, &env);
+
+  double ok_us = best_us([&]{
+    for(int i = 0; i < repeat; i++) interpreter::eval_program(&ok, &env);
+  }) / repeat;
+
+  size_t msg_bytes = 0;
+  double err_us = best_us([&]{
+    for(int i = 0; i < repeat; i++){
+      try {
+        interpreter::eval_program(&bad, &env);
+      } catch(const std::exception& e){
+        msg_bytes = std::string(e.what()).size();
+      } catch(...){
+        msg_bytes = 0; // anything else isn't a usable error
+      }
+    }
+  }) / repeat;
+
+  std::printf("%6d %12.2f %10.1f %12.2f %10zu\n", depth, ok_us, ok_us * 1000 / depth, err_us, msg_bytes);
+}
+
+int main(){
+  std::printf("%6s %12s %10s %12s %10s\n", "depth", "eval us", "ns/node", "error us", "msg bytes");
+  run(100, 2000);
+  run(1000, 200);
+  run(4000, 50);
+  return 0;
+}
@@ -0,0 +1,67 @@
+// tree walker vs bytecode vm on the same resolved program
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+#include "vm/compiler.hpp"
+#include "vm/vm.hpp"
+
+static std::string arith_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\nmut c = 0;\n";
+  for(int i = 0; i < stmts; i++){
+    src += "mut c = a * b + (a - b) % 3 / 2 + c * 0 + " + std::to_string(i % 97) + ";\n";
+  }
+  return src + "c\n";
+}
+
+static std::string logic_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\nmut n;\n";
+  for(int i = 0; i < stmts; i++){
+    src += "mut c = a < b and b >= 4 or n == nil and a != b;\n";
+  }
+  return src + "c\n";
+}
+
+static double best_ms(const std::function<void()>& fn){
+  double best = 1e30;
+  for(int run = 0; run < 5; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  return best;
+}
+
+static void compare(const char* name, const std::string& src){
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+
+  symtable::environment env;
+  resolver::resolve(prog, &env);
+
+  interpreter::value tree_ret, vm_ret;
+  double tree = best_ms([&]{ tree_ret = interpreter::eval_program(&prog, &env); });
+
+  vm::chunk code;
+  double compile = best_ms([&]{ code = vm::compile(prog); });
+  double run = best_ms([&]{ vm_ret = vm::run(code, &env); });
+
+  std::printf("%-8s %10zu %10.2f %12.2f %10.2f %8.2fx\n", name, prog.body.size(),
+              tree, compile, run, tree / run);
+
+  if(!interpreter::values_equal(tree_ret, vm_ret)) std::printf("  results differ!\n");
+}
+
+int main(){
+  std::printf("%-8s %10s %10s %12s %10s %9s\n", "script", "stmts", "tree ms", "compile ms", "vm ms", "speedup");
+  compare("arith", arith_script(200000));
+  compare("logic", logic_script(200000));
+  return 0;
+}
@@ -0,0 +1,77 @@
+// binary dispatch through a site's inline cache vs the generic pair table,
+// then the cache stats of a mixed type script run a few times
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+static const int CALLS = 5000000;
+
+template<class Fn>
+static double best_ns(Fn fn){
+  double best = 1e30;
+  for(int run = 0; run < 15; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::nano>(end - begin).count() / CALLS);
+  }
+  return best;
+}
+
+static void dispatch(const char* label, parser::binary_op op, interpreter::value lhs, interpreter::value rhs){
+  parser::binary_exp site(nullptr, nullptr, op);
+  double sink = 0;
+
+  double generic = best_ns([&]{
+    for(int i = 0; i < CALLS; i++){
+      auto out = interpreter::apply_binary(op, lhs, rhs, 1);
+      sink += out.type;
+    }
+  });
+  double cached = best_ns([&]{
+    for(int i = 0; i < CALLS; i++){
+      auto out = interpreter::cached_binary(&site, lhs, rhs);
+      sink += out.type;
+    }
+  });
+
+  std::printf("%-16s %-3s %10.2f %10.2f %s\n", label, std::string(parser::op_spelling(op)).c_str(),
+              generic, cached, sink < 0 ? "!" : "");
+}
+
+static void mixed_script(){
+  std::string src = "mut a = 7;\nmut b = 3;\nmut n;\nmut t = 1 < 2;\n";
+  for(int i = 0; i < 20000; i++){
+    src += "a * b + (n + a) - b / 2\n";       // monomorphic, nil + number at the inner site
+    src += "(a < b) == t\n";
+  }
+
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+  symtable::environment env;
+  resolver::resolve(prog, &env);
+
+  for(int run = 0; run < 5; run++) interpreter::eval_program(&prog, &env);
+  interpreter::dump_feedback(prog, std::cout);
+}
+
+int main(){
+  using interpreter::make_number;
+  std::printf("%-16s %-3s %10s %10s\n", "operands", "op", "generic ns", "cached ns");
+  dispatch("number number", parser::OP_ADD, make_number(7), make_number(3));
+  dispatch("number number", parser::OP_MOD, make_number(7), make_number(3));
+  dispatch("number number", parser::OP_LESS, make_number(7), make_number(3));
+  dispatch("nil number", parser::OP_ADD, interpreter::make_nil(), make_number(3));
+  dispatch("bool bool", parser::OP_EQ, interpreter::make_bool(true), interpreter::make_bool(false));
+
+  std::printf("\n");
+  mixed_script();
+  return 0;
+}
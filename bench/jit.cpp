@@ -0,0 +1,124 @@
+// native numeric fragments vs the plain tree walker
+// first a differential check on random expressions (exit 1 on any mismatch),
+// then timings on arithmetic heavy scripts
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "jit/x64.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+static std::mt19937 rng(7);
+
+// mostly numbers, with nil/bool slots and zeros to force deopts
+static std::string atom(){
+  static const char* atoms[] = {"a", "b", "c", "d", "z", "n", "t", "big",
+                                "0", "1", "2", "3.5", "0.25", "7", "(0 - 1)", "2147483648"};
+  return atoms[rng() % 16];
+}
+
+static std::string expr(int depth){
+  if(depth == 0 || rng() % 4 == 0) return atom();
+  static const char* ops[] = {"+", "-", "*", "/", "%"};
+  return "(" + expr(depth - 1) + " " + ops[rng() % 5] + " " + expr(depth - 1) + ")";
+}
+
+// value or error text, numbers compared bit for bit
+static std::string outcome(const std::string& src, bool native){
+  symtable::environment env;
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+  resolver::resolve(prog, &env);
+
+  jit::code_cache code;
+  if(native) code.compile(prog);
+
+  try {
+    interpreter::value ret = interpreter::eval_program(&prog, &env);
+    if(ret.type != interpreter::NUMBER) return interpreter::value_type_name(ret.type);
+    uint64_t bits;
+    std::memcpy(&bits, &ret.number, sizeof(bits));
+    return std::to_string(bits);
+  } catch(const interpreter::error& e){
+    return std::string("error: ") + e.what();
+  }
+}
+
+static int differential(int cases){
+  const std::string prelude =
+    "mut a = 3;\nmut b = 0 - 4.5;\nmut c = 12;\nmut d = 0.1;\nmut z = 0;\n"
+    "mut n = nil;\nmut t = true;\nmut big = 3000000000;\n";
+
+  int mismatches = 0;
+  for(int i = 0; i < cases; i++){
+    std::string src = prelude + "mut a = " + expr(3) + ";\n" + expr(5) + "\n";
+    std::string tree = outcome(src, false);
+    std::string native = outcome(src, true);
+    if(tree != native){
+      if(++mismatches <= 5) std::printf("mismatch:\n%s  tree:   %s\n  native: %s\n", src.c_str(), tree.c_str(), native.c_str());
+    }
+  }
+  std::printf("differential: %d cases, %d mismatches\n", cases, mismatches);
+  return mismatches;
+}
+
+static std::string variable_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\nmut c = 5;\nmut d = 6;\n";
+  for(int i = 0; i < stmts; i++){
+    src += "mut d = (a + b * c - d + a * b) % 1000 / 3 + (c - a) * (b + c) - a / b;\n";
+  }
+  return src + "d\n";
+}
+
+static double best_ms(const std::function<void()>& fn){
+  double best = 1e30;
+  for(int run = 0; run < 5; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  return best;
+}
+
+static void compare(const char* name, const std::string& src){
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+  symtable::environment env;
+  resolver::resolve(prog, &env);
+
+  interpreter::value plain_ret, native_ret;
+  double plain = best_ms([&]{ plain_ret = interpreter::eval_program(&prog, &env); });
+
+  jit::code_cache code;
+  auto begin = std::chrono::steady_clock::now();
+  size_t fragments = code.compile(prog);
+  double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+  double native = best_ms([&]{ native_ret = interpreter::eval_program(&prog, &env); });
+
+  std::printf("%-9s %8zu %10zu %9.2f %9.2f %10.2f %8.2fx\n", name, prog.body.size(), fragments,
+              build, plain, native, plain / native);
+  if(!interpreter::values_equal(plain_ret, native_ret)) std::printf("  results differ!\n");
+}
+
+int main(){
+#ifndef MEOW_HAS_JIT
+  std::printf("no native backend on this platform, nothing to measure\n");
+  return 0;
+#else
+  if(differential(20000)) return 1;
+
+  std::printf("%-9s %8s %10s %9s %9s %10s %9s\n",
+              "script", "stmts", "fragments", "build ms", "tree ms", "native ms", "speedup");
+  compare("variable", variable_script(200000));
+  return 0;
+#endif
+}
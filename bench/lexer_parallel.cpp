@@ -0,0 +1,94 @@
+// parallel lexing vs scan_tokens -- token for token identical (exit 1 if not),
+// then throughput at 1, 2, 4 and 8 threads
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "lexer/parallel.hpp"
+#include "lexer/tokenizer.hpp"
+
+static std::string make_script(int stmts, bool long_strings){
+  std::string src;
+  for(int i = 0; i < stmts; i++){
+    src += "mut value_" + std::to_string(i) + " = (" + std::to_string(i) +
+           ".25 * 3 + other_" + std::to_string(i % 97) + ") % 7; $ a \"quote\" in a comment\n";
+    if(i % 50 == 0) src += "\"a string\nover two lines\" >= <= != ==\n";
+    // strings long enough that chunk boundaries land inside them
+    if(long_strings && i % 5000 == 0) src += "\"" + std::string(300000, 'x') + "\nstill inside\n\"\n";
+  }
+  return src;
+}
+
+static bool same_token(const lexer::token& a, const lexer::token& b){
+  if(a.type != b.type || a.line != b.line || a.value != b.value) return false;
+  if(a.type == lexer::IDENTIFIER) return a.symbol == b.symbol;
+  if(a.type == lexer::NUMBER) return std::memcmp(&a.number, &b.number, sizeof(double)) == 0;
+  return true;
+}
+
+// tokens, or the error text -- keep keeps the buffer the tokens view into
+static std::string lex(const std::string& src, size_t threads, lexer::token_list& out, lexer::source_ptr& keep){
+  utils::thread_pool pool(threads);
+  auto tok_obj = lexer::new_tokenizer_runtime(src);
+  try {
+    if(threads) lexer::scan_tokens_parallel(tok_obj, pool);
+    else lexer::scan_tokens(tok_obj);
+  } catch(const std::runtime_error& e) {
+    return e.what();
+  }
+  out = std::move(tok_obj.tokens);
+  keep = tok_obj.buffer;
+  return "";
+}
+
+static int differential(const char* name, const std::string& src){
+  lexer::token_list serial;
+  lexer::source_ptr serial_src, parallel_src;
+  std::string serial_err = lex(src, 0, serial, serial_src);
+  int bad = 0;
+  for(size_t threads : {1, 2, 3, 4, 8, 16}){
+    lexer::token_list parallel;
+    std::string err = lex(src, threads, parallel, parallel_src);
+    bool same = err == serial_err && parallel.size() == serial.size() &&
+                std::equal(parallel.begin(), parallel.end(), serial.begin(), same_token);
+    if(!same){
+      std::printf("%s: %zu threads differ from scan_tokens\n", name, threads);
+      bad++;
+    }
+  }
+  std::printf("%-14s %9zu tokens %s\n", name, serial.size(), serial_err.empty() ? "" : "(error)");
+  return bad;
+}
+
+int main(){
+  int bad = 0;
+  bad += differential("plain", make_script(50000, false));
+  bad += differential("long strings", make_script(50000, true));
+  bad += differential("late error", make_script(50000, false) + "mut x = 1 @ 2;\n" + make_script(1000, false));
+  bad += differential("open string", make_script(50000, false) + "\"never closed\n" + make_script(1000, false));
+  if(bad) return 1;
+
+  std::string src = make_script(400000, false);
+  double mb = src.size() / (1024.0 * 1024.0);
+  std::printf("\nsource = %.1f MB, %u hardware threads\n", mb, std::thread::hardware_concurrency());
+  std::printf("%8s %10s %10s %9s\n", "threads", "ms", "MB/s", "speedup");
+
+  double base = 0;
+  for(size_t threads : {1, 2, 4, 8}){
+    utils::thread_pool pool(threads);
+    double best = 1e30;
+    for(int run = 0; run < 5; run++){
+      auto tok_obj = lexer::new_tokenizer_runtime(src);
+      auto begin = std::chrono::steady_clock::now();
+      lexer::scan_tokens_parallel(tok_obj, pool);
+      best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+    if(threads == 1) base = best;
+    std::printf("%8zu %10.2f %10.1f %8.2fx\n", threads, best, mb / (best / 1000), base / best);
+  }
+  return 0;
+}
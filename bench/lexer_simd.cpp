@@ -0,0 +1,56 @@
+// lexer throughput per simd level -- every level must match scalar token for token
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "lexer/tokenizer.hpp"
+
+static std::string make_script(int stmts){
+  std::string src;
+  for(int i = 0; i < stmts; i++){
+    src += "        mut a_fairly_long_generated_identifier_" + std::to_string(i) +
+           " = 1234567890.0987654321 * (other_name_" + std::to_string(i) + " + 42);";
+    if(i % 4 == 0) src += "   \"a string literal\nthat spans a line " + std::to_string(i) + "\"";
+    if(i % 3 == 0) src += "   $ trailing comment explaining the statement in some detail";
+    src += "\n\n";
+  }
+  return src;
+}
+
+static lexer::tokenizer lex(const std::string& src, double& mb_per_s){
+  auto tok_obj = lexer::new_tokenizer_runtime(src);
+  auto begin = std::chrono::steady_clock::now();
+  lexer::scan_tokens(tok_obj);
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  mb_per_s = src.size() / (1024.0 * 1024.0) / s;
+  return tok_obj; // keeps the buffer the tokens view into
+}
+
+int main(){
+  std::string src = make_script(200000);
+  std::printf("source = %.1f MB, best level = %s\n",
+              src.size() / (1024.0 * 1024.0), lexer::simd::level_name(lexer::simd::best_level()));
+
+  double speed = 0;
+  lexer::simd::use(lexer::simd::level::SCALAR);
+  auto scalar_run = lex(src, speed);
+  auto& reference = scalar_run.tokens;
+  std::printf("%-8s %10.1f MB/s\n", "scalar", speed);
+
+  for(auto lvl : {lexer::simd::level::SSE2, lexer::simd::level::AVX2}){
+    if(lvl > lexer::simd::best_level()) continue;
+    lexer::simd::use(lvl);
+    auto run = lex(src, speed);
+    auto& toks = run.tokens;
+
+    bool same = toks.size() == reference.size();
+    for(size_t i = 0; same && i < toks.size(); i++){
+      same = toks[i].type == reference[i].type && toks[i].line == reference[i].line &&
+             toks[i].value == reference[i].value;
+    }
+    std::printf("%-8s %10.1f MB/s  %s\n", lexer::simd::level_name(lvl), speed,
+                same ? "matches scalar" : "MISMATCH");
+    if(!same) return 1;
+  }
+  return 0;
+}
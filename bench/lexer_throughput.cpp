@@ -0,0 +1,56 @@
+// lexer throughput, allocations and token size on a large generated file
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "lexer/tokenizer.hpp"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size){
+  allocations++;
+  if(void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static std::string make_script(int stmts){
+  std::string src;
+  for(int i = 0; i < stmts; i++){
+    src += "mut value_" + std::to_string(i) + " = (" + std::to_string(i) +
+           ".25 * 3 + 17) % 7; $ generated line\n";
+  }
+  return src;
+}
+
+int main(){
+  std::string src = make_script(400000);
+  double mb = src.size() / (1024.0 * 1024.0);
+  std::printf("sizeof(token) = %zu bytes, source = %.1f MB\n", sizeof(lexer::token), mb);
+
+  // streaming: one token at a time, as the parser consumes them
+  {
+    auto tok_obj = lexer::new_tokenizer_runtime(src);
+    size_t before = allocations, count = 0;
+    auto begin = std::chrono::steady_clock::now();
+    while(lexer::next_token(tok_obj).type != lexer::END_OF_FILE) count++;
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("stream: %zu tokens, %8.1f MB/s, %zu allocations\n",
+                count, mb / s, allocations - before);
+  }
+
+  // batch: full token_list
+  {
+    auto tok_obj = lexer::new_tokenizer_runtime(src);
+    size_t before = allocations;
+    auto begin = std::chrono::steady_clock::now();
+    lexer::scan_tokens(tok_obj);
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("batch:  %zu tokens, %8.1f MB/s, %zu allocations\n",
+                tok_obj.tokens.size(), mb / s, allocations - before);
+  }
+  return 0;
+}
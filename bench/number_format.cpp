@@ -0,0 +1,84 @@
+// number -> text throughput: what print_value and string concatenation used
+// to do (ostream <<, std::to_string) against utils::format_number
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/number_format.hpp"
+
+static const int COUNT = 2000000;
+
+static double best_ms(const std::function<void()>& fn){
+  double best = 1e30;
+  for(int run = 0; run < 3; run++){
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  return best;
+}
+
+// small integers, fractions and wide exponents, like script output
+static std::vector<double> sample(){
+  std::mt19937_64 rng(3);
+  std::vector<double> nums(COUNT);
+  for(int i = 0; i < COUNT; i++){
+    switch(i % 3){
+      case 0: nums[i] = static_cast<double>(rng() % 100000); break;
+      case 1: nums[i] = static_cast<double>(rng() % 1000000) / 7.0; break;
+      default: nums[i] = std::ldexp(static_cast<double>(rng() >> 11), static_cast<int>(rng() % 200) - 150); break;
+    }
+  }
+  return nums;
+}
+
+int main(){
+  auto nums = sample();
+  std::string out;
+  out.reserve(COUNT * 25);
+
+  // each writes every number plus a newline into out, then checks it round trips
+  double ostream_ms = best_ms([&]{
+    std::ostringstream os;
+    for(double n : nums) os << n << '\n';
+    out = os.str();
+  });
+  size_t ostream_bytes = out.size();
+
+  double to_string_ms = best_ms([&]{
+    out.clear();
+    for(double n : nums){ out += std::to_string(n); out += '\n'; }
+  });
+  size_t to_string_bytes = out.size();
+
+  double format_ms = best_ms([&]{
+    out.clear();
+    utils::number_buffer buf;
+    for(double n : nums){ out += utils::format_number(n, buf); out += '\n'; }
+  });
+  size_t format_bytes = out.size();
+
+  // shortest round trip: parse everything back, must be bit identical
+  size_t bad = 0, pos = 0;
+  for(double n : nums){
+    size_t end = out.find('\n', pos);
+    double back = 0;
+    std::from_chars(out.data() + pos, out.data() + end, back);
+    if(back != n) bad++;
+    pos = end + 1;
+  }
+
+  std::printf("%-14s %10s %10s %10s  (%d numbers)\n", "formatter", "ms", "ns/num", "bytes", COUNT);
+  std::printf("%-14s %10.2f %10.1f %10zu  6 significant digits, lossy\n", "ostream <<", ostream_ms, ostream_ms * 1e6 / COUNT, ostream_bytes);
+  std::printf("%-14s %10.2f %10.1f %10zu  6 decimals, lossy\n", "std::to_string", to_string_ms, to_string_ms * 1e6 / COUNT, to_string_bytes);
+  std::printf("%-14s %10.2f %10.1f %10zu  shortest, %zu failed to round trip\n", "format_number", format_ms, format_ms * 1e6 / COUNT, format_bytes, bad);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+// parse_parallel vs make_ast -- same tree and the same first error, lex or
+// parse (exit 1 if not), then lex + parse time at 1, 2, 4 and 8 threads
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache/meowc.hpp"
+#include "parser/parallel.hpp"
+#include "parser/parser.hpp"
+
+static std::string make_script(int decls){
+  std::string src = "mut v0 = 1;\n";
+  for(int i = 1; i < decls; i++){
+    src += "mut v" + std::to_string(i) + " = " + std::to_string(i) +
+           " * 3 + (v" + std::to_string(i - 1) + " - 2) % 7;\n";
+    if(i % 100 == 0) src += "v" + std::to_string(i) + " < 4 v1 + 2\n"; // statements without `;`
+    if(i % 1000 == 0) src += "mut later;\n";
+  }
+  return src;
+}
+
+// the tree as bytes (kinds, ops, values, symbols, lines), or the error text
+static std::string outcome(const std::string& src, size_t threads){
+  try {
+    parser::program prog;
+    if(threads){
+      utils::thread_pool pool(threads);
+      prog = parser::parse_parallel(lexer::new_tokenizer_runtime(src), pool);
+    } else {
+      parser::parse parsed(lexer::new_tokenizer_runtime(src));
+      prog = parsed.make_ast();
+    }
+    cache::writer out;
+    if(!out.encode(prog)) return "unencodable";
+    return out.bytes(cache::key{});
+  } catch(const std::runtime_error& e) {
+    return std::string("error: ") + e.what();
+  }
+}
+
+static int differential(const char* name, const std::string& src){
+  std::string serial = outcome(src, 0);
+  int bad = 0;
+  for(size_t threads : {1, 2, 3, 4, 8, 16}){
+    if(outcome(src, threads) != serial){
+      std::printf("%s: %zu threads differ from make_ast\n", name, threads);
+      bad++;
+    }
+  }
+  std::printf("%-22s %s\n", name, serial.rfind("error: ", 0) == 0 ? serial.c_str() : "same tree");
+  return bad;
+}
+
+// a constant without a value reports the line of the token after its `;`,
+// which at a cut is the stand in END_OF_FILE -- slide one across the cuts
+static int sweep_cut_errors(){
+  std::vector<std::string> lines;
+  for(int i = 0; i < 1200; i++) lines.push_back("mut v" + std::to_string(i) + " = " + std::to_string(i) + " * 3 + 1;\n");
+
+  int bad = 0;
+  for(size_t at = 300; at < 900; at++){
+    std::string src;
+    for(size_t i = 0; i < lines.size(); i++) src += (i == at ? "var c;\n\n\n" : "") + lines[i];
+    std::string serial = outcome(src, 0);
+    for(size_t threads : {2, 4}){
+      if(outcome(src, threads) != serial) bad++;
+    }
+  }
+  std::printf("%-22s %s\n", "error at each cut", bad ? "differs" : "same error");
+  return bad;
+}
+
+int main(){
+  const std::string src = make_script(100000);
+  const size_t half = src.find('\n', src.size() / 2) + 1; // a line start
+
+  int bad = 0;
+  bad += differential("100k declarations", src);
+  // two errors, the first in source order has to win no matter which slice finishes first
+  bad += differential("two errors", src.substr(0, half) + "mut x = (1 + ;\n" + src.substr(half) + "mut y = ) ;\n");
+  // the whole file is lexed up front, but a parse error before a lex error still comes first
+  bad += differential("parse then lex error", "mut = 5;\n" + src + "@\n");
+  bad += differential("same statement", src.substr(0, half) + "mut = 5 @;\n" + src.substr(half));
+  bad += differential("lex then parse error", src.substr(0, half) + "mut x = 1 @ 2;\n" + src.substr(half) + "mut = 5;\n");
+  bad += sweep_cut_errors();
+  bad += differential("missing semicolon", src.substr(0, half) + "mut z = 1\n" + src.substr(half));
+  if(bad) return 1;
+
+  std::printf("\n%u hardware threads\n", std::thread::hardware_concurrency());
+  std::printf("%8s %8s %10s %10s %9s\n", "decls", "threads", "serial ms", "ms", "speedup");
+  for(int decls : {100000, 400000}){
+    const std::string script = make_script(decls);
+
+    double serial = 1e30;
+    for(int run = 0; run < 3; run++){
+      auto begin = std::chrono::steady_clock::now();
+      parser::parse parsed(lexer::new_tokenizer_runtime(script));
+      auto prog = parsed.make_ast();
+      serial = std::min(serial, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+    }
+
+    for(size_t threads : {1, 2, 4, 8}){
+      utils::thread_pool pool(threads);
+      double best = 1e30;
+      for(int run = 0; run < 3; run++){
+        auto begin = std::chrono::steady_clock::now();
+        auto prog = parser::parse_parallel(lexer::new_tokenizer_runtime(script), pool);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+      }
+      std::printf("%8d %8zu %10.2f %10.2f %8.2fx\n", decls, threads, serial, best, serial / best);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,36 @@
+// parse time vs input size -- should be linear (flat ns/stmt)
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+
+static std::string make_script(int stmts){
+  std::string src;
+  src += "mut v0 = 1;\n";
+  for(int i = 1; i < stmts; i++){
+    src += "mut v" + std::to_string(i) + " = " + std::to_string(i) +
+           " * 3 + (v" + std::to_string(i - 1) + " - 2) % 7;\n";
+  }
+  return src;
+}
+
+int main(){
+  std::printf("%10s %12s %12s %10s\n", "stmts", "bytes", "parse ms", "ns/stmt");
+
+  for(int stmts : {1000, 10000, 100000}){
+    std::string src = make_script(stmts);
+
+    auto begin = std::chrono::steady_clock::now();
+    parser::parse parsed(lexer::new_tokenizer_runtime(src));
+    auto prog = parsed.make_ast();
+    auto end = std::chrono::steady_clock::now();
+
+    double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+    std::printf("%10d %12zu %12.2f %10.1f\n", stmts, src.size(), ms, ms * 1e6 / stmts);
+
+    if(prog.body.size() != static_cast<size_t>(stmts)) return 1;
+  }
+  return 0;
+}
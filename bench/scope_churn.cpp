@@ -0,0 +1,69 @@
+// cost of entering and leaving a scope: declare k locals, read them, pop
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "interpreter/values.hpp"
+#include "symtable/environment.hpp"
+
+using clock_type = std::chrono::steady_clock;
+
+static const int ROUNDS = 1000000;
+
+// per scope hash table of boxed values, what every environment used to be
+using hashed_scope = std::unordered_map<symtable::symbol_id, std::unique_ptr<interpreter::value>>;
+
+static double ns_per_round(clock_type::time_point begin){
+  return std::chrono::duration<double, std::nano>(clock_type::now() - begin).count() / ROUNDS;
+}
+
+int main(){
+  symtable::environment globals;
+  std::vector<symtable::symbol_id> names;
+  for(int i = 0; i < 16; i++){
+    names.push_back(symtable::intern("local" + std::to_string(i)));
+  }
+
+  std::printf("%8s %14s %14s %14s\n", "locals", "hashed ns", "named ns", "block ns");
+
+  for(uint32_t k : {0u, 2u, 8u, 16u}){
+    double sum = 0;
+
+    auto begin = clock_type::now();
+    for(int r = 0; r < ROUNDS; r++){
+      hashed_scope scope;
+      for(uint32_t i = 0; i < k; i++) scope[names[i]] = std::make_unique<interpreter::value>(interpreter::make_number(i));
+      for(uint32_t i = 0; i < k; i++){
+        sum += scope.find(names[i])->second->number;
+      }
+    }
+    double hashed = ns_per_round(begin);
+
+    begin = clock_type::now();
+    for(int r = 0; r < ROUNDS; r++){
+      symtable::environment scope(&globals);
+      for(uint32_t i = 0; i < k; i++) scope.declare_variable(names[i], interpreter::make_number(i));
+      for(uint32_t i = 0; i < k; i++){
+        sum += scope.lookup_variable(names[i])->number;
+      }
+    }
+    double named = ns_per_round(begin);
+
+    begin = clock_type::now();
+    for(int r = 0; r < ROUNDS; r++){
+      symtable::environment scope(&globals, k);
+      for(uint32_t i = 0; i < k; i++) scope.declare_at(i, names[i], interpreter::make_number(i));
+      for(uint32_t i = 0; i < k; i++){
+        sum += scope.lookup_at(0, i)->number;
+      }
+    }
+    double block = ns_per_round(begin);
+
+    std::printf("%8u %14.1f %14.1f %14.1f\n", k, hashed, named, block);
+    if(sum < 0) return 1;
+  }
+  return 0;
+}
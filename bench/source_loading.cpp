@@ -0,0 +1,92 @@
+// STREAM tokens held in the parser's lookahead keep their text across refills
+// (exit 1 if not), then startup time and peak RSS per load mode on a
+// multi-hundred-MB script
+// RSS includes the interned names too -- every line here declares a new one,
+// so even stream keeps a few hundred MB of them
+// usage: source_loading [MB] (default 256)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "lexer/token_stream.hpp"
+#include "lexer/tokenizer.hpp"
+
+static const char* PATH = "/tmp/meow_source_loading.meow";
+
+static void write_script(size_t mb){
+  std::ofstream out(PATH, std::ios::binary);
+  std::string line;
+  size_t written = 0;
+  for(size_t i = 0; written < mb << 20; i++){
+    line = "mut value_" + std::to_string(i) + " = (" + std::to_string(i) +
+           ".5 * 3 + 17) % 7; $ generated line\n";
+    out << line;
+    written += line.size();
+  }
+}
+
+// two tokens in the lookahead with whitespace and comments running over several
+// 16 byte chunks between them -- the first one's text must survive the refills
+static int held_tokens_check(){
+  const char* path = "/tmp/meow_source_loading_held.meow";
+  int bad = 0;
+  for(size_t pad = 0; pad < 32; pad++){
+    std::ofstream(path, std::ios::binary) << std::string(pad, ' ') << "held_one" << std::string(40, ' ')
+      << "$ " << std::string(100, 'c') << "\n$ " << std::string(100, 'd') << "\nheld_two\n";
+
+    lexer::token_stream stream(lexer::tokenizer(std::make_shared<lexer::chunk_reader>(path, 16)));
+    stream.peek(1); // scans held_two while held_one sits in slot 0
+    if(stream.peek(0).text() != "held_one" || stream.peek(1).text() != "held_two") bad++;
+  }
+  std::remove(path);
+  std::printf("held STREAM tokens     %s\n", bad ? "garbled" : "intact");
+  return bad;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point t){
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+}
+
+static void run(const char* name, lexer::load_mode mode){
+  std::fflush(stdout); // child must not re-flush the header
+  pid_t pid = fork();
+  if(pid == 0){
+    auto begin = std::chrono::steady_clock::now();
+    auto tok_obj = lexer::new_tokenizer(PATH, mode);
+    auto first = lexer::next_token(tok_obj);
+    double startup = ms_since(begin);
+
+    size_t count = 1;
+    while(lexer::next_token(tok_obj).type != lexer::END_OF_FILE) count++;
+    std::printf("%-8s %12.2f %12.1f %12zu", name, startup, ms_since(begin), count);
+    std::fflush(stdout);
+    _exit(first.type == lexer::UNKOWN);
+  }
+
+  int status = 0;
+  struct rusage usage;
+  wait4(pid, &status, 0, &usage);
+  std::printf(" %10ld\n", usage.ru_maxrss / 1024);
+}
+
+int main(int argc, char** argv){
+  size_t mb = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+  if(held_tokens_check()) return 1;
+
+  write_script(mb);
+
+  std::printf("%zu MB script\n", mb);
+  std::printf("%-8s %12s %12s %12s %10s\n", "mode", "startup ms", "total ms", "tokens", "RSS MB");
+  run("read", lexer::load_mode::READ);
+  run("mmap", lexer::load_mode::MMAP);
+  run("stream", lexer::load_mode::STREAM);
+
+  std::remove(PATH);
+  return 0;
+}
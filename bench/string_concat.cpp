@@ -0,0 +1,64 @@
+// building large strings through repeated + -- the language has no loops or
+// string literals yet, so the loops are unrolled and the pieces bound from
+// the host side. ns/append should stay flat as the string grows
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+// s = s + t, n times: lhs is a variable, so it is always shared
+static std::string accumulate_script(int n){
+  std::string src;
+  for(int i = 0; i < n; i++) src += "mut s = s + t;\n";
+  return src + "s\n";
+}
+
+// s + t + t + ... in one expression: every lhs but the first is a temporary
+static std::string chain_script(int n){
+  std::string src = "s";
+  for(int i = 0; i < n; i++) src += " + t";
+  return src + "\n";
+}
+
+// s = s + 1, numbers turned into text on the way
+static std::string number_script(int n){
+  std::string src;
+  for(int i = 0; i < n; i++) src += "mut s = s + " + std::to_string(i % 10) + ";\n";
+  return src + "s\n";
+}
+
+static void run(const char* name, const std::string& src, int appends){
+  symtable::environment env;
+  env.declare_variable(symtable::intern("s"), interpreter::make_string(""));
+  env.declare_variable(symtable::intern("t"), interpreter::make_string("sixteen bytes..."));
+
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+  resolver::resolve(prog, &env);
+
+  auto begin = std::chrono::steady_clock::now();
+  auto ret = interpreter::eval_program(&prog, &env);
+  size_t bytes = ret.str().size(); // flattens, so it is part of the time
+  auto end = std::chrono::steady_clock::now();
+  double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+
+  std::printf("%-11s %8d %10zu %10.2f %10.1f\n", name, appends, bytes, ms, ms * 1e6 / appends);
+}
+
+int main(){
+  std::printf("%-11s %8s %10s %10s %10s\n", "script", "appends", "bytes", "eval ms", "ns/append");
+  for(int n : {1000, 10000, 50000}){
+    run("accumulate", accumulate_script(n), n);
+  }
+  for(int n : {1000, 5000, 10000}){ // one expression, the tree walker recurses per term
+    run("chain", chain_script(n), n);
+  }
+  for(int n : {1000, 10000, 50000}){
+    run("numbers", number_script(n), n);
+  }
+  return 0;
+}
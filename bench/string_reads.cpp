@@ -0,0 +1,42 @@
+// reading large string variables: every read used to copy the whole text
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+// the parser has no string literals yet, so s is bound from the host side
+static std::string make_script(int reads){
+  std::string src;
+  for(int i = 0; i < reads; i++){
+    src += (i % 2) ? "s\n" : "new t = s;\n";
+  }
+  return src;
+}
+
+int main(){
+  std::printf("%10s %8s %12s %12s\n", "str bytes", "reads", "eval ms", "ns/read");
+
+  for(size_t bytes : {16, 1024, 1 << 20}){
+    const int reads = bytes > 4096 ? 2000 : 200000;
+
+    symtable::environment env;
+    env.declare_variable(symtable::intern("s"), interpreter::make_string(std::string(bytes, 'm')));
+
+    parser::parse parsed(lexer::new_tokenizer_runtime(make_script(reads)));
+    auto prog = parsed.make_ast();
+    resolver::resolve(prog, &env);
+
+    auto begin = std::chrono::steady_clock::now();
+    auto ret = interpreter::eval_program(&prog, &env);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+
+    std::printf("%10zu %8d %12.2f %12.1f\n", bytes, reads, ms, ms * 1e6 / reads);
+    if(ret.str().size() != bytes) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+// heap allocations per evaluated AST node
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "optimizer/optimizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size){
+  void* p = std::malloc(size);
+  if(!p) throw std::bad_alloc();
+  allocations++;
+  return p;
+}
+// pairs with the malloc in operator new above
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+static std::string make_script(int stmts){
+  std::string src = "mut a = 3;\nmut b = 4;\n";
+  for(int i = 0; i < stmts; i++){
+    src += "mut c = a * b + (a - b) % 3 / 2 + nil + " + std::to_string(i) + ";\n";
+  }
+  return src;
+}
+
+int main(){
+  std::printf("%8s %10s %12s %14s %10s\n", "stmts", "nodes", "allocs", "allocs/node", "eval ms");
+
+  for(int stmts : {1000, 100000}){
+    parser::parse parsed(lexer::new_tokenizer_runtime(make_script(stmts)));
+    auto prog = parsed.make_ast();
+    size_t nodes = optimizer::count_nodes(&prog) - 1; // the program node isn't evaluated
+
+    symtable::environment env;
+    resolver::resolve(prog, &env);
+
+    size_t before = allocations;
+    auto begin = std::chrono::steady_clock::now();
+    interpreter::eval_program(&prog, &env);
+    auto end = std::chrono::steady_clock::now();
+    size_t allocs = allocations - before;
+
+    std::printf("%8d %10zu %12zu %14.2f %10.2f\n", stmts, nodes, allocs,
+                static_cast<double>(allocs) / nodes,
+                std::chrono::duration<double, std::milli>(end - begin).count());
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+// lookup heavy eval: hashed name lookups vs resolver (depth, slot) addresses
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "interpreter/interpreter.hpp"
+#include "lexer/tokenizer.hpp"
+#include "parser/parser.hpp"
+#include "resolver/resolver.hpp"
+
+// `vars` bindings, then statements reading four of them each -- g lives a scope up
+static std::string make_script(int vars, int stmts){
+  std::string src;
+  for(int i = 0; i < vars; i++){
+    src += "mut v" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+  }
+  for(int i = 0; i < stmts; i++){
+    auto v = [&](int k){ return "v" + std::to_string((i * 7 + k * 13) % vars); };
+    src += "mut r = " + v(0) + " + " + v(1) + " * " + v(2) + " - " + v(3) + " + g;\n";
+  }
+  return src;
+}
+
+static double eval_ms(bool resolve, const std::string& src, double& last){
+  symtable::environment globals;
+  globals.declare_variable(symtable::intern("g"), interpreter::make_number(1));
+  symtable::environment env(&globals);
+
+  parser::parse parsed(lexer::new_tokenizer_runtime(src));
+  auto prog = parsed.make_ast();
+  if(resolve) resolver::resolve(prog, &env);
+
+  auto begin = std::chrono::steady_clock::now();
+  auto ret = interpreter::eval_program(&prog, &env);
+  auto end = std::chrono::steady_clock::now();
+  last = ret.number;
+  return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// the lookups alone, without eval's per node allocations around them
+static void raw_lookups(int vars){
+  symtable::environment globals;
+  globals.declare_variable(symtable::intern("g"), interpreter::make_number(1));
+  symtable::environment env(&globals);
+
+  std::vector<symtable::symbol_id> names;
+  for(int i = 0; i < vars; i++){
+    names.push_back(symtable::intern("v" + std::to_string(i)));
+    env.declare_variable(names.back(), interpreter::make_number(i));
+  }
+
+  const int rounds = 4000000;
+  double sum = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for(int i = 0; i < rounds; i++){
+    sum += env.lookup_variable(names[(i * 7) % vars])->number;
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for(int i = 0; i < rounds; i++){
+    sum -= env.lookup_at(0, (i * 7) % vars)->number;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double hashed = std::chrono::duration<double, std::nano>(mid - begin).count() / rounds;
+  double resolved = std::chrono::duration<double, std::nano>(end - mid).count() / rounds;
+  std::printf("%8d %10d %12.2f %14.2f %7.2fx\n", vars, rounds, hashed, resolved, hashed / resolved);
+  if(sum != 0) std::exit(1);
+}
+
+int main(){
+  std::printf("raw environment lookups\n");
+  std::printf("%8s %10s %12s %14s %8s\n", "vars", "lookups", "hashed ns", "resolved ns", "speedup");
+  for(int vars : {16, 1000, 100000}) raw_lookups(vars);
+
+  std::printf("\nfull eval\n");
+  std::printf("%8s %10s %12s %14s %8s\n", "vars", "lookups", "hashed ms", "resolved ms", "speedup");
+
+  for(int vars : {16, 1000, 100000}){
+    const int stmts = 100000;
+    std::string src = make_script(vars, stmts);
+
+    double hashed_last = 0, resolved_last = 0;
+    double hashed = eval_ms(false, src, hashed_last);
+    double resolved = eval_ms(true, src, resolved_last);
+
+    std::printf("%8d %10d %12.2f %14.2f %7.2fx\n",
+                vars, stmts * 5, hashed, resolved, hashed / resolved);
+
+    if(hashed_last != resolved_last) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,445 @@
+#ifndef MEOWC_HPP
+#define MEOWC_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lexer/source.hpp"
+#include "parser/node_types.hpp"
+#include "symtable/interner.hpp"
+
+// part of every cache key, a build with a different version rebuilds its caches
+#ifndef MEOW_VERSION
+#define MEOW_VERSION "0.1"
+#endif
+
+namespace cache {
+
+// bump when the record layout, the parser or the optimizer changes what it produces
+inline constexpr uint32_t FORMAT_VERSION = 1;
+inline constexpr char MAGIC[8] = {'M', 'E', 'O', 'W', 'C', 0, 0, 0};
+
+/*
+ * .meowc layout, host byte order (the magic/format check rejects foreign files):
+ *   file_header
+ *   version text, script path          -- header says how long
+ *   symbols: varint length + bytes     -- ids are file local, re-interned on load
+ *   nodes, post order                  -- children first, so no child indices:
+ *                                         the loader keeps a stack and each
+ *                                         statement leaves its root on it
+ * a node is a tag byte (kind in the low 4 bits, op / flags above), the line
+ * as a zigzag varint delta from the previous node, then its payload.
+ * payload_hash covers everything after the header
+ * */
+struct file_header {
+  char magic[8];
+  uint32_t format;
+  uint32_t optimized;
+  uint64_t source_hash;
+  uint64_t source_size;
+  uint64_t payload_hash;
+  uint64_t payload_size;
+  uint32_t version_len;
+  uint32_t path_len;
+  uint32_t symbol_count;
+  uint32_t node_count;
+  uint32_t body_count;
+  uint32_t reserved;
+};
+
+static_assert(parser::OP_COUNT <= 16, "binary ops share the tag byte with the node kind");
+
+// high tag bits
+inline constexpr uint8_t SMALL_INT = 1 << 4; // numeric literal: varint instead of 8 raw bytes
+inline constexpr uint8_t MUT = 1 << 4;       // var_dec
+inline constexpr uint8_t HAS_INIT = 1 << 5;  // var_dec: pops its initializer
+
+// 8 bytes per step, FNV style mixing -- only guards against stale/corrupt files
+inline uint64_t hash_bytes(std::string_view bytes) {
+  constexpr uint64_t PRIME = 0x100000001b3ull;
+  uint64_t h = 0xcbf29ce484222325ull ^ bytes.size();
+  size_t i = 0;
+  for (; i + 8 <= bytes.size(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, 8);
+    h = (h ^ word) * PRIME;
+    h ^= h >> 29;
+  }
+  for (; i < bytes.size(); i++) {
+    h = (h ^ static_cast<uint8_t>(bytes[i])) * PRIME;
+  }
+  return h;
+}
+
+// what a cache file has to match to be used
+struct key {
+  uint64_t source_hash = 0;
+  uint64_t source_size = 0;
+  bool optimized = false;
+  std::string path; // absolute script path
+};
+
+inline key make_key(const std::string& script, std::string_view source, bool optimized) {
+  std::error_code ec;
+  auto abs = std::filesystem::absolute(script, ec);
+  return key{hash_bytes(source), source.size(), optimized, ec ? script : abs.lexically_normal().string()};
+}
+
+// foo.meow.meowc next to foo.meow, or <hash of the path>.meowc inside dir
+// -- appended, not swapped in, so foo.meow, foo.txt and foo get their own
+inline std::string cache_file(const key& k, const std::string& script, const std::string& dir) {
+  if (dir.empty()) return script + ".meowc";
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.meowc",
+                static_cast<unsigned long long>(hash_bytes(k.path)));
+  return (std::filesystem::path(dir) / name).string();
+}
+
+// ---- writing ----
+
+class writer {
+public:
+  // false when the tree has a node kind the format doesn't cover
+  bool encode(const parser::program& prgrm) {
+    for (auto* stmt : prgrm.body) {
+      if (!add(stmt)) return false;
+    }
+    body_count = static_cast<uint32_t>(prgrm.body.size());
+    return true;
+  }
+
+  std::string bytes(const key& k) const {
+    std::string payload;
+    const std::string_view version = MEOW_VERSION;
+    payload += version;
+    payload += k.path;
+    for (auto sym : symbols) {
+      std::string name = symtable::symbol_name(sym);
+      put_varint(payload, name.size());
+      payload += name;
+    }
+    payload += nodes;
+
+    file_header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format = FORMAT_VERSION;
+    header.optimized = k.optimized;
+    header.source_hash = k.source_hash;
+    header.source_size = k.source_size;
+    header.payload_hash = hash_bytes(payload);
+    header.payload_size = payload.size();
+    header.version_len = static_cast<uint32_t>(version.size());
+    header.path_len = static_cast<uint32_t>(k.path.size());
+    header.symbol_count = static_cast<uint32_t>(symbols.size());
+    header.node_count = node_count;
+    header.body_count = body_count;
+
+    std::string out(reinterpret_cast<const char*>(&header), sizeof(header));
+    return out + payload;
+  }
+
+  static void put_varint(std::string& out, uint64_t v) {
+    while (v >= 0x80) {
+      out += static_cast<char>(v | 0x80);
+      v >>= 7;
+    }
+    out += static_cast<char>(v);
+  }
+
+private:
+  std::string nodes;
+  uint32_t node_count = 0;
+  uint32_t body_count = 0;
+  int last_line = 0;
+  std::vector<symtable::symbol_id> symbols;
+  std::unordered_map<symtable::symbol_id, uint32_t> symbol_index;
+
+  uint32_t local_symbol(symtable::symbol_id sym) {
+    auto [it, fresh] = symbol_index.try_emplace(sym, static_cast<uint32_t>(symbols.size()));
+    if (fresh) symbols.push_back(sym);
+    return it->second;
+  }
+
+  void put_node(uint8_t tag, int line) {
+    nodes += static_cast<char>(tag);
+    int64_t delta = static_cast<int64_t>(line) - last_line;
+    put_varint(nodes, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63)); // zigzag
+    last_line = line;
+    node_count++;
+  }
+
+  // post order without recursion, expressions can be thousands deep
+  bool add(const parser::statement* root) {
+    struct frame { const parser::statement* node; bool expanded; };
+    std::vector<frame> todo{{root, false}};
+
+    while (!todo.empty()) {
+      frame top = todo.back();
+      todo.pop_back();
+      const parser::statement* node = top.node;
+
+      if (!top.expanded) {
+        todo.push_back({node, true});
+        if (node->kind == parser::BINARY_EXP) {
+          auto* bin = static_cast<const parser::binary_exp*>(node);
+          todo.push_back({bin->right, false});
+          todo.push_back({bin->left, false}); // left finishes first
+        } else if (node->kind == parser::VAR_DEC) {
+          auto* decl = static_cast<const parser::var_dec*>(node);
+          if (decl->type) todo.push_back({decl->type, false});
+        }
+        continue;
+      }
+
+      const uint8_t kind = static_cast<uint8_t>(node->kind);
+      switch (node->kind) {
+        case parser::NUMERIC_LITERAL: {
+          double num = static_cast<const parser::numeric_literal*>(node)->value;
+          // small integers (not -0) as varints, everything else bit exact
+          if (num >= 0 && num < 1e15 && num == static_cast<double>(static_cast<uint64_t>(num)) &&
+              !(num == 0 && std::signbit(num))) {
+            put_node(kind | SMALL_INT, node->line);
+            put_varint(nodes, static_cast<uint64_t>(num));
+          } else {
+            put_node(kind, node->line);
+            nodes.append(reinterpret_cast<const char*>(&num), sizeof(num));
+          }
+          break;
+        }
+        case parser::NULL_LITERAL:
+          put_node(kind, node->line);
+          break;
+        case parser::IDENTIFIER:
+          put_node(kind, node->line);
+          put_varint(nodes, local_symbol(static_cast<const parser::identifier*>(node)->symbol));
+          break;
+        case parser::BINARY_EXP:
+          put_node(kind | static_cast<uint8_t>(static_cast<const parser::binary_exp*>(node)->op << 4), node->line);
+          break;
+        case parser::VAR_DEC: {
+          auto* decl = static_cast<const parser::var_dec*>(node);
+          put_node(kind | (decl->mut ? MUT : 0) | (decl->type ? HAS_INIT : 0), node->line);
+          put_varint(nodes, local_symbol(decl->identifier));
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+};
+
+// written to a temp file and renamed over, readers never see half a cache
+inline bool save(const parser::program& prgrm, const key& k, const std::string& file) {
+  writer out;
+  if (!out.encode(prgrm)) return false;
+
+  std::error_code ec;
+  auto dir = std::filesystem::path(file).parent_path();
+  if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+
+  // unique per save: other processes differ in pid, --batch workers share one
+  static std::atomic<uint64_t> saves{0};
+  const std::string count = std::to_string(saves.fetch_add(1, std::memory_order_relaxed));
+#ifdef MEOW_HAS_MMAP
+  const std::string tmp = file + ".tmp" + std::to_string(getpid()) + "." + count;
+#else
+  const std::string tmp = file + ".tmp" + count;
+#endif
+  {
+    std::ofstream stream(tmp, std::ios::binary | std::ios::trunc);
+    if (!stream) return false;
+    const std::string bytes = out.bytes(k);
+    stream.write(bytes.data(), bytes.size());
+    if (!stream) return false;
+  }
+  std::filesystem::rename(tmp, file, ec);
+  if (ec) std::filesystem::remove(tmp, ec);
+  return !ec;
+}
+
+// ---- reading ----
+
+enum class load_status {
+  LOADED,
+  MISSING,
+  STALE,   // valid file for another source, version or optimize setting
+  CORRUPT, // truncated, bad checksum or bad indices
+};
+
+inline const char* load_status_name(load_status status) {
+  switch (status) {
+    case load_status::LOADED:  return "loaded";
+    case load_status::MISSING: return "missing";
+    case load_status::STALE:   return "stale";
+    case load_status::CORRUPT: return "corrupt";
+  }
+  return "unknown";
+}
+
+// bounds checked cursor over the payload, any overrun marks it bad
+struct reader {
+  std::string_view bytes;
+  size_t pos = 0;
+  bool bad = false;
+
+  std::string_view take(size_t len) {
+    if (bad || len > bytes.size() - pos) {
+      bad = true;
+      return {};
+    }
+    pos += len;
+    return bytes.substr(pos - len, len);
+  }
+
+  uint8_t byte() {
+    auto b = take(1);
+    return bad ? 0 : static_cast<uint8_t>(b[0]);
+  }
+
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t b = byte();
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    bad = true;
+    return 0;
+  }
+};
+
+/*
+ * bytes -> AST in out's arena. nodes can only pop what earlier nodes
+ * pushed and every symbol index is checked, so a damaged file fails
+ * cleanly instead of producing a broken tree
+ * */
+inline load_status decode(std::string_view bytes, const key& k, parser::program& out) {
+  file_header header;
+  if (bytes.size() < sizeof(header)) return load_status::CORRUPT;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return load_status::CORRUPT;
+
+  const std::string_view payload = bytes.substr(sizeof(header));
+  if (header.payload_size != payload.size() || header.payload_hash != hash_bytes(payload)) {
+    return load_status::CORRUPT;
+  }
+
+  if (header.format != FORMAT_VERSION || header.optimized != static_cast<uint32_t>(k.optimized) ||
+      header.source_hash != k.source_hash || header.source_size != k.source_size) {
+    return load_status::STALE;
+  }
+
+  reader in{payload};
+  std::string_view version = in.take(header.version_len);
+  std::string_view path = in.take(header.path_len);
+  if (in.bad) return load_status::CORRUPT;
+  if (version != MEOW_VERSION || path != k.path) return load_status::STALE;
+
+  std::vector<symtable::symbol_id> symbols;
+  symbols.reserve(std::min<size_t>(header.symbol_count, payload.size()));
+  for (uint32_t i = 0; i < header.symbol_count && !in.bad; i++) {
+    std::string_view name = in.take(in.varint());
+    symbols.push_back(symtable::intern(name));
+  }
+  if (in.bad) return load_status::CORRUPT;
+
+  std::vector<parser::statement*> stack;
+  auto pop_expression = [&]() -> parser::expression* {
+    if (stack.empty() || stack.back()->kind == parser::VAR_DEC) return nullptr;
+    auto* exp = static_cast<parser::expression*>(stack.back());
+    stack.pop_back();
+    return exp;
+  };
+  auto symbol = [&](uint64_t index, symtable::symbol_id& sym) {
+    if (index >= symbols.size()) return false;
+    sym = symbols[index];
+    return true;
+  };
+
+  int line = 0;
+  for (uint32_t i = 0; i < header.node_count; i++) {
+    const uint8_t tag = in.byte();
+    const uint64_t zigzag = in.varint();
+    line += static_cast<int>(static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1));
+    if (in.bad) return load_status::CORRUPT;
+
+    parser::statement* node = nullptr;
+    symtable::symbol_id sym;
+    switch (tag & 0x0f) {
+      case parser::NUMERIC_LITERAL: {
+        double num;
+        if (tag & SMALL_INT) {
+          num = static_cast<double>(in.varint());
+        } else {
+          std::string_view raw = in.take(sizeof(num));
+          if (in.bad) return load_status::CORRUPT;
+          std::memcpy(&num, raw.data(), sizeof(num));
+        }
+        node = out.nodes.make<parser::numeric_literal>(num);
+        break;
+      }
+      case parser::NULL_LITERAL:
+        node = out.nodes.make<parser::nil_literal>("nil");
+        break;
+      case parser::IDENTIFIER:
+        if (!symbol(in.varint(), sym)) return load_status::CORRUPT;
+        node = out.nodes.make<parser::identifier>(sym);
+        break;
+      case parser::BINARY_EXP: {
+        auto* r = pop_expression();
+        auto* l = pop_expression();
+        if (!l || !r || (tag >> 4) >= parser::OP_COUNT) return load_status::CORRUPT;
+        node = out.nodes.make<parser::binary_exp>(l, r, static_cast<parser::binary_op>(tag >> 4));
+        break;
+      }
+      case parser::VAR_DEC: {
+        parser::expression* init = nullptr;
+        if ((tag & HAS_INIT) && !(init = pop_expression())) return load_status::CORRUPT;
+        if (!symbol(in.varint(), sym)) return load_status::CORRUPT;
+        node = out.nodes.make<parser::var_dec>((tag & MUT) != 0, sym, init);
+        break;
+      }
+      default:
+        return load_status::CORRUPT;
+    }
+    if (in.bad) return load_status::CORRUPT;
+    node->line = line;
+    stack.push_back(node);
+  }
+
+  // whatever is left are the statements, in order
+  if (in.pos != payload.size() || stack.size() != header.body_count) return load_status::CORRUPT;
+  out.body = std::move(stack);
+  return load_status::LOADED;
+}
+
+// maps the cache file and decodes it -- out is only meaningful on LOADED
+inline load_status load(const std::string& file, const key& k, parser::program& out) {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(file, ec)) return load_status::MISSING;
+
+  lexer::source_ptr mapped;
+  try {
+    mapped = lexer::map_source(file);
+  } catch (const std::exception&) {
+    return load_status::MISSING;
+  }
+  return decode(mapped->view(), k, out);
+}
+
+}
+
+#endif
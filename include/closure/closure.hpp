@@ -0,0 +1,182 @@
+#ifndef CLOSURE_HPP
+#define CLOSURE_HPP
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "interpreter/operators.hpp"
+#include "parser/node_types.hpp"
+#include "symtable/environment.hpp"
+
+namespace closure {
+
+using interpreter::value;
+using parser::binary_op;
+
+// one pre-bound piece of the program -- call it to evaluate that subtree
+using thunk = std::function<value(symtable::environment*)>;
+
+/*
+ * walks the AST once and returns closures with node kinds, operators,
+ * slots and literal operands already baked in -- running the program is
+ * then nested indirect calls, no switch on ast_node->kind anywhere
+ * run it after the resolver, like the vm compiler
+ * */
+class compiler {
+public:
+  thunk compile(const parser::statement* node) {
+    switch (node->kind) {
+      case parser::NUMERIC_LITERAL: {
+        value constant = interpreter::make_number(static_cast<const parser::numeric_literal*>(node)->value);
+        return [constant](symtable::environment*) { return constant; };
+      }
+
+      case parser::NULL_LITERAL:
+        return [](symtable::environment*) { return value(); };
+
+      case parser::IDENTIFIER:
+        return compile_identifier(static_cast<const parser::identifier*>(node));
+
+      case parser::VAR_DEC:
+        return compile_var_dec(static_cast<const parser::var_dec*>(node));
+
+      case parser::BINARY_EXP:
+        return compile_binary(static_cast<const parser::binary_exp*>(node));
+
+      case parser::PROGRAM:
+        return compile_program(static_cast<const parser::program*>(node));
+
+      default:
+        throw std::runtime_error("COMPILER: AST Node kind not implemented for closures on line " +
+                                 std::to_string(node->line));
+    }
+  }
+
+private:
+  static interpreter::error undefined(symtable::symbol_id sym, int line) {
+    return interpreter::error(interpreter::error_kind::UNDEFINED_VARIABLE,
+                              "Undefined variable: " + symtable::symbol_name(sym), line);
+  }
+
+  thunk compile_program(const parser::program* prgrm) {
+    std::vector<thunk> body;
+    body.reserve(prgrm->body.size());
+    for (auto* stmt : prgrm->body) {
+      body.push_back(compile(stmt));
+    }
+
+    return [body = std::move(body)](symtable::environment* env) {
+      value last_eval;
+      for (const auto& stmt : body) {
+        last_eval = stmt(env);
+      }
+      return last_eval;
+    };
+  }
+
+  thunk compile_identifier(const parser::identifier* ident) {
+    const auto sym = ident->symbol;
+    const int line = ident->line;
+    if (!ident->addr.resolved()) {
+      return [sym, line](symtable::environment* env) {
+        auto* val = env->lookup_variable(sym);
+        if (!val) throw undefined(sym, line);
+        return *val;
+      };
+    }
+
+    const auto addr = ident->addr;
+    return [sym, addr, line](symtable::environment* env) {
+      auto* val = env->lookup_at(addr.depth, addr.slot);
+      if (!val) val = env->lookup_variable(sym); // env changed under us
+      if (!val) throw undefined(sym, line);
+      return *val;
+    };
+  }
+
+  thunk compile_var_dec(const parser::var_dec* decl) {
+    thunk init = decl->type ? compile(decl->type) : thunk([](symtable::environment*) { return value(); });
+    const auto sym = decl->identifier;
+
+    if (!decl->addr.resolved()) {
+      return [init = std::move(init), sym](symtable::environment* env) {
+        return *env->declare_variable(sym, init(env));
+      };
+    }
+
+    const auto slot = decl->addr.slot;
+    return [init = std::move(init), sym, slot](symtable::environment* env) {
+      return *env->declare_at(slot, sym, init(env));
+    };
+  }
+
+  thunk compile_binary(const parser::binary_exp* bin) {
+    thunk lhs = compile(bin->left);
+
+    if (bin->op == parser::OP_AND || bin->op == parser::OP_OR) {
+      const bool want = bin->op == parser::OP_OR; // truthiness that short circuits
+      return [lhs = std::move(lhs), rhs = compile(bin->right), want](symtable::environment* env) {
+        value l = lhs(env);
+        if (interpreter::is_truthy(l) == want) return l;
+        return rhs(env);
+      };
+    }
+
+    switch (bin->op) {
+      case parser::OP_ADD:        return binary<parser::OP_ADD>(std::move(lhs), bin);
+      case parser::OP_SUB:        return binary<parser::OP_SUB>(std::move(lhs), bin);
+      case parser::OP_MUL:        return binary<parser::OP_MUL>(std::move(lhs), bin);
+      case parser::OP_DIV:        return binary<parser::OP_DIV>(std::move(lhs), bin);
+      case parser::OP_MOD:        return binary<parser::OP_MOD>(std::move(lhs), bin);
+      case parser::OP_EQ:         return binary<parser::OP_EQ>(std::move(lhs), bin);
+      case parser::OP_NOT_EQ:     return binary<parser::OP_NOT_EQ>(std::move(lhs), bin);
+      case parser::OP_LESS:       return binary<parser::OP_LESS>(std::move(lhs), bin);
+      case parser::OP_LESS_EQ:    return binary<parser::OP_LESS_EQ>(std::move(lhs), bin);
+      case parser::OP_GREATER:    return binary<parser::OP_GREATER>(std::move(lhs), bin);
+      case parser::OP_GREATER_EQ: return binary<parser::OP_GREATER_EQ>(std::move(lhs), bin);
+      default:
+        throw std::runtime_error("COMPILER: Unknown binary operator on line " + std::to_string(bin->line));
+    }
+  }
+
+  // a literal right operand is captured as a double rather than called for
+  template<binary_op OP>
+  thunk binary(thunk lhs, const parser::binary_exp* bin) {
+    const int line = bin->line;
+
+    if (bin->right->kind == parser::NUMERIC_LITERAL) {
+      const double r = static_cast<const parser::numeric_literal*>(bin->right)->value;
+      return [lhs = std::move(lhs), r, line](symtable::environment* env) {
+        value l = lhs(env);
+        if (l.type == interpreter::NUMBER) return interpreter::num_num<OP>(l.number, r, line);
+        value rv = interpreter::make_number(r);
+        return interpreter::apply_binary(OP, l, rv, line);
+      };
+    }
+
+    return [lhs = std::move(lhs), rhs = compile(bin->right), line](symtable::environment* env) {
+      value l = lhs(env);
+      value r = rhs(env);
+      if (l.type == interpreter::NUMBER && r.type == interpreter::NUMBER) {
+        return interpreter::num_num<OP>(l.number, r.number, line);
+      }
+      return interpreter::apply_binary(OP, l, r, line);
+    };
+  }
+};
+
+inline thunk compile(const parser::program& prgrm) {
+  return compiler().compile(&prgrm);
+}
+
+// drop in for interpreter::eval_program
+inline value eval_program(parser::program* prgrm, symtable::environment* env) {
+  return compile(*prgrm)(env);
+}
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ERROR_HPP
+#define ERROR_HPP
+
+#include <stdexcept>
+#include <string>
+
+namespace interpreter {
+
+enum class error_kind {
+  UNDEFINED_VARIABLE,
+  DIVISION_BY_ZERO,
+  BAD_OPERANDS,
+  UNSUPPORTED,       // node kind or operator the engine doesn't handle
+};
+
+inline const char* error_kind_name(error_kind kind) {
+  switch (kind) {
+    case error_kind::UNDEFINED_VARIABLE: return "undefined variable";
+    case error_kind::DIVISION_BY_ZERO:   return "division by zero";
+    case error_kind::BAD_OPERANDS:       return "bad operands";
+    case error_kind::UNSUPPORTED:        return "unsupported";
+  }
+  return "unknown";
+}
+
+/*
+ * the one error evaluation throws, from whichever engine. it is thrown
+ * where the problem is found and nothing catches it on the way up -- the
+ * only handler is whoever called eval_program (main, the REPL) -- so
+ * deep trees pay nothing for error handling until something goes wrong.
+ * what() is formatted once, at the throw
+ * */
+struct error : std::runtime_error {
+  error_kind kind;
+  std::string message; // without the prefix and line
+  int line;            // 0 when unknown
+
+  error(error_kind k, std::string msg, int ln)
+      : std::runtime_error("INTERPRETER: " + msg + (ln > 0 ? " on line " + std::to_string(ln) : "")),
+        kind(k), message(std::move(msg)), line(ln) {}
+};
+
+}
+
+#endif
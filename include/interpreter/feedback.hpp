@@ -0,0 +1,131 @@
+#ifndef FEEDBACK_HPP
+#define FEEDBACK_HPP
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+#include "interpreter/operators.hpp"
+#include "parser/node_types.hpp"
+
+namespace interpreter {
+
+/*
+ * inline caches for binary operators. each binary_exp remembers the operand
+ * type pairs it has seen (site_cache in node_types.hpp) with a handler
+ * specialized on op and both types, so a hit skips the pair table and the
+ * op switch. a miss records the new pair, or with the cache full marks the
+ * site megamorphic -- those go straight to apply_binary from then on.
+ * hit/miss counts live on the site too, dump_feedback adds them up
+ * */
+// op and operand types fixed: numbers become one expression, the rest
+// a direct call to their pair handler
+template<binary_op OP, value_type L, value_type R>
+value specialized(value& lhs, value& rhs, int line) {
+  if constexpr (L == NUMBER && R == NUMBER && OP < parser::OP_AND) {
+    return num_num<OP>(lhs.number, rhs.number, line);
+  } else {
+    return pair_handlers[L][R](OP, lhs, rhs, line);
+  }
+}
+
+template<binary_op OP, size_t... KEY>
+constexpr auto specialized_row(std::index_sequence<KEY...>) {
+  return std::array<parser::site_cache::handler, sizeof...(KEY)>{
+    &specialized<OP, static_cast<value_type>(KEY / 4), static_cast<value_type>(KEY % 4)>...
+  };
+}
+
+template<size_t... OP>
+constexpr auto specialized_table(std::index_sequence<OP...>) {
+  return std::array<std::array<parser::site_cache::handler, 16>, sizeof...(OP)>{
+    specialized_row<static_cast<binary_op>(OP)>(std::make_index_sequence<16>())...
+  };
+}
+
+// [op][lhs type * 4 + rhs type], and/or never get here but keep the indexing flat
+inline constexpr auto specialized_handlers = specialized_table(std::make_index_sequence<parser::OP_COUNT>());
+
+inline value cached_binary(parser::binary_exp* exp, value& lhs, value& rhs) {
+  auto& cache = exp->cache;
+  const uint8_t key = static_cast<uint8_t>(lhs.type * 4 + rhs.type);
+
+  // monomorphic sites settle on the first compare
+  if (cache.size && cache.keys[0] == key) {
+    cache.hits++;
+    return cache.targets[0](lhs, rhs, exp->line);
+  }
+  for (int i = 1; i < cache.size; i++) {
+    if (cache.keys[i] == key) {
+      cache.hits++;
+      return cache.targets[i](lhs, rhs, exp->line);
+    }
+  }
+
+  cache.misses++;
+  if (cache.megamorphic || cache.size == parser::site_cache::ways) {
+    cache.megamorphic = true; // stop growing, the pairs already cached still hit
+    return apply_binary(exp->op, lhs, rhs, exp->line);
+  }
+  cache.keys[cache.size] = key;
+  cache.targets[cache.size] = specialized_handlers[exp->op][key];
+  return cache.targets[cache.size++](lhs, rhs, exp->line);
+}
+
+// how many sites ended up in each state
+struct site_counts {
+  uint64_t unused = 0;
+  uint64_t monomorphic = 0;
+  uint64_t polymorphic = 0;
+  uint64_t megamorphic = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+inline void count_sites(const parser::statement* node, site_counts& out) {
+  if (!node) return;
+  switch (node->kind) {
+    case parser::PROGRAM:
+      for (auto* stmt : static_cast<const parser::program*>(node)->body) count_sites(stmt, out);
+      break;
+
+    case parser::VAR_DEC:
+      count_sites(static_cast<const parser::var_dec*>(node)->type, out);
+      break;
+
+    case parser::BINARY_EXP: {
+      auto* bin = static_cast<const parser::binary_exp*>(node);
+      count_sites(bin->left, out);
+      count_sites(bin->right, out);
+      if (bin->op == parser::OP_AND || bin->op == parser::OP_OR) break; // no cache, never dispatched
+      out.hits += bin->cache.hits;
+      out.misses += bin->cache.misses;
+      if (bin->cache.megamorphic) out.megamorphic++;
+      else if (bin->cache.size == 0) out.unused++;
+      else if (bin->cache.size == 1) out.monomorphic++;
+      else out.polymorphic++;
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+// --stats: where the program's operator sites ended up and how often they hit
+inline void dump_feedback(const parser::program& prgrm, std::ostream& out) {
+  site_counts sites;
+  count_sites(&prgrm, sites);
+  const uint64_t total = sites.hits + sites.misses;
+
+  out << "operator sites: " << sites.monomorphic << " monomorphic, " << sites.polymorphic
+      << " polymorphic, " << sites.megamorphic << " megamorphic, " << sites.unused << " never run\n";
+  out << "cache: " << sites.hits << " hits, " << sites.misses << " misses";
+  if (total) out << " (" << (100.0 * sites.hits / total) << "% hit)";
+  out << "\n";
+}
+
+}
+
+#endif
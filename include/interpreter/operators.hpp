@@ -0,0 +1,202 @@
+#ifndef OPERATORS_HPP
+#define OPERATORS_HPP
+
+#include <stdexcept>
+#include <string>
+
+#include "interpreter/error.hpp"
+#include "interpreter/values.hpp"
+#include "parser/node_types.hpp"
+#include "utils/number_format.hpp"
+
+namespace interpreter {
+
+using parser::binary_op;
+
+// true when op would raise the division by zero error for this rhs
+inline bool divides_by_zero(binary_op op, double rhs) {
+  return (op == parser::OP_DIV && rhs == 0.0) || (op == parser::OP_MOD && static_cast<int>(rhs) == 0);
+}
+
+// numeric semantics shared with the optimizer's constant folding -- arithmetic ops only
+inline double num_binary_op(double lhs, double rhs, binary_op op, int line) {
+  if (divides_by_zero(op, rhs)) {
+    throw error(error_kind::DIVISION_BY_ZERO, "Division by zero error", line);
+  }
+
+  switch (op) {
+    case parser::OP_ADD: return lhs + rhs;
+    case parser::OP_SUB: return lhs - rhs;
+    case parser::OP_MUL: return lhs * rhs;
+    case parser::OP_DIV: return lhs / rhs;
+    case parser::OP_MOD: return static_cast<double>(static_cast<int>(lhs) % static_cast<int>(rhs));
+    default:
+      throw error(error_kind::UNSUPPORTED, "Unknown numeric operator: " + std::string(parser::op_spelling(op)), line);
+  }
+}
+
+// number x number with the op fixed at compile time, the closure engine and
+// inline caches use this so each call is one expression
+template<binary_op OP>
+inline value num_num(double l, double r, int line) {
+  if constexpr (OP == parser::OP_ADD) return make_number(l + r);
+  else if constexpr (OP == parser::OP_SUB) return make_number(l - r);
+  else if constexpr (OP == parser::OP_MUL) return make_number(l * r);
+  else if constexpr (OP == parser::OP_DIV || OP == parser::OP_MOD) {
+    return make_number(num_binary_op(l, r, OP, line));
+  }
+  else if constexpr (OP == parser::OP_EQ) return make_bool(l == r);
+  else if constexpr (OP == parser::OP_NOT_EQ) return make_bool(l != r);
+  else if constexpr (OP == parser::OP_LESS) return make_bool(l < r);
+  else if constexpr (OP == parser::OP_LESS_EQ) return make_bool(l <= r);
+  else if constexpr (OP == parser::OP_GREATER) return make_bool(l > r);
+  else return make_bool(l >= r);
+}
+
+inline const char* value_type_name(value_type type) {
+  switch (type) {
+    case NIL:    return "nil";
+    case NUMBER: return "number";
+    case BOOL:   return "bool";
+    case STR:    return "string";
+  }
+  return "unknown";
+}
+
+[[noreturn]] inline void bad_operands(binary_op op, const value& lhs, const value& rhs, int line) {
+  throw error(error_kind::BAD_OPERANDS, "Cannot apply `" + std::string(parser::op_spelling(op)) + "` to " +
+    value_type_name(lhs.type) + " and " + value_type_name(rhs.type), line);
+}
+
+// same type and same contents -- never an error, mixed types are just unequal
+inline bool values_equal(const value& lhs, const value& rhs) {
+  if (lhs.type != rhs.type) return false;
+  switch (lhs.type) {
+    case NIL:    return true;
+    case NUMBER: return lhs.number == rhs.number;
+    case BOOL:   return lhs.boolean == rhs.boolean;
+    case STR:    return lhs.string == rhs.string || lhs.str() == rhs.str();
+  }
+  return false;
+}
+
+// coalesce nil values: return first non-nil, or nil if both are nil
+inline value nil_coalesce(value lhs, value rhs) {
+  if (!is_nil(lhs)) {
+    return lhs;
+  }
+  return rhs;
+}
+
+// text of one operand of a string concatenation, nil adds nothing
+inline void append_text(std::string& out, const value& val) {
+  switch (val.type) {
+    case STR:    out += val.str(); break;
+    case NUMBER: utils::append_number(out, val.number); break;
+    case BOOL:   out += val.boolean ? "true" : "false"; break;
+    case NIL:    break;
+  }
+}
+
+// below this many string bytes a copy is cheaper than a rope node
+inline constexpr size_t rope_min = 64;
+
+/*
+ * string concatenation, cheapest first:
+ * - a flat lhs nobody else holds (the previous + of a chain) is appended to in place
+ * - nil adds nothing, the string side is shared as is
+ * - long operands are linked into a rope, copied when the result is read
+ * - short ones are copied into a fresh string
+ * */
+inline value concat(value& lhs, value& rhs) {
+  if (lhs.type == STR && !lhs.string->is_rope() && lhs.string->refs.load(std::memory_order_acquire) == 1) {
+    append_text(lhs.string->text, rhs);
+    return std::move(lhs);
+  }
+  if (lhs.type == NIL && rhs.type == STR) return rhs;
+  if (rhs.type == NIL && lhs.type == STR) return lhs;
+
+  auto as_string = [](const value& val) {
+    if (val.type == STR) return val;
+    std::string text;
+    append_text(text, val);
+    return make_string(std::move(text));
+  };
+
+  const size_t linked = (lhs.type == STR ? lhs.string->size() : 0) + (rhs.type == STR ? rhs.string->size() : 0);
+  if (linked >= rope_min) {
+    value l = as_string(lhs);
+    value r = as_string(rhs);
+    return make_rope(l.string, r.string);
+  }
+
+  std::string result;
+  append_text(result, lhs);
+  append_text(result, rhs);
+  return make_string(std::move(result));
+}
+
+/*
+ * binary operators dispatch twice through tables, never on strings:
+ * the operand type pair picks a handler, the handler switches on the op enum
+ * (dense, so that's a jump table too). and/or short circuit before operands
+ * are both evaluated, see eval_binary_exp
+ * */
+using binary_handler = value (*)(binary_op op, value& lhs, value& rhs, int line);
+
+inline value equality(binary_op op, const value& lhs, const value& rhs) {
+  return make_bool(values_equal(lhs, rhs) == (op == parser::OP_EQ));
+}
+
+inline value num_num(binary_op op, value& lhs, value& rhs, int line) {
+  const double l = lhs.number;
+  const double r = rhs.number;
+  switch (op) {
+    case parser::OP_EQ:         return make_bool(l == r);
+    case parser::OP_NOT_EQ:     return make_bool(l != r);
+    case parser::OP_LESS:       return make_bool(l < r);
+    case parser::OP_LESS_EQ:    return make_bool(l <= r);
+    case parser::OP_GREATER:    return make_bool(l > r);
+    case parser::OP_GREATER_EQ: return make_bool(l >= r);
+    default:                    return make_number(num_binary_op(l, r, op, line));
+  }
+}
+
+// any string operand: arithmetic concatenates, ordering needs two strings
+inline value str_any(binary_op op, value& lhs, value& rhs, int line) {
+  if (parser::is_arithmetic(op)) return concat(lhs, rhs);
+  if (op == parser::OP_EQ || op == parser::OP_NOT_EQ) return equality(op, lhs, rhs);
+  if (lhs.type != STR || rhs.type != STR) bad_operands(op, lhs, rhs, line);
+
+  const int cmp = lhs.str().compare(rhs.str());
+  switch (op) {
+    case parser::OP_LESS:       return make_bool(cmp < 0);
+    case parser::OP_LESS_EQ:    return make_bool(cmp <= 0);
+    case parser::OP_GREATER:    return make_bool(cmp > 0);
+    case parser::OP_GREATER_EQ: return make_bool(cmp >= 0);
+    default:                    bad_operands(op, lhs, rhs, line);
+  }
+}
+
+// nil and bools: arithmetic coalesces to the first non-nil, only equality compares
+inline value coalescing(binary_op op, value& lhs, value& rhs, int line) {
+  if (parser::is_arithmetic(op)) return nil_coalesce(std::move(lhs), std::move(rhs));
+  if (op == parser::OP_EQ || op == parser::OP_NOT_EQ) return equality(op, lhs, rhs);
+  bad_operands(op, lhs, rhs, line);
+}
+
+// [lhs type][rhs type], rows and columns in value_type order: NIL NUMBER BOOL STR
+inline constexpr binary_handler pair_handlers[4][4] = {
+  /* NIL    */ {coalescing, coalescing, coalescing, str_any},
+  /* NUMBER */ {coalescing, num_num,    coalescing, str_any},
+  /* BOOL   */ {coalescing, coalescing, coalescing, str_any},
+  /* STR    */ {str_any,    str_any,    str_any,    str_any},
+};
+
+inline value apply_binary(binary_op op, value& lhs, value& rhs, int line) {
+  return pair_handlers[lhs.type][rhs.type](op, lhs, rhs, line);
+}
+
+}
+
+#endif
@@ -1,99 +1,208 @@
-
 #ifndef VALUES_HPP
 #define VALUES_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <string>
-#include <memory>
+#include <utility>
+#include <vector>
 
 namespace interpreter {
 
 enum value_type {
-  NIL, 
+  NIL,
   NUMBER,
   BOOL,
   STR,
 };
 
-struct runtime_val {
-  value_type type;
+/*
+ * shared string payload -- immutable while more than one value holds it
+ * a concat node (rope) holds left + right instead of the text: `s + t`
+ * links the two payloads and the bytes get copied once, when something
+ * first reads the text (flatten). reading flattens in place, so two
+ * threads must not read the same unflattened rope at once
+ * */
+struct string_obj {
+  std::string text;              // the contents once flat
+  string_obj* left = nullptr;    // concat children, both set or both null
+  string_obj* right = nullptr;
+  size_t length = 0;             // ropes only, flat text can change under edit_str
+  std::atomic<uint32_t> refs{1}; // atomic so frames can be shared across threads
+
+  explicit string_obj(std::string txt) : text(std::move(txt)) {}
+
+  // takes a reference on both halves
+  string_obj(string_obj* l, string_obj* r) : left(l), right(r), length(l->size() + r->size()) {
+    l->refs.fetch_add(1, std::memory_order_relaxed);
+    r->refs.fetch_add(1, std::memory_order_relaxed);
+  }
 
-  virtual std::unique_ptr<runtime_val> clone() const = 0;
+  bool is_rope() const {
+    return left != nullptr;
+  }
 
-  explicit runtime_val(value_type t): type(t) {}
-  virtual ~runtime_val() = default;
+  size_t size() const {
+    return is_rope() ? length : text.size();
+  }
 };
 
-struct nil_val: public runtime_val {
-  nil_val(): runtime_val(NIL) {}
+// drops one reference -- a loop rather than recursion, ropes can be millions deep
+inline void release(string_obj* obj) {
+  if (obj->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  if (!obj->is_rope()) {
+    delete obj;
+    return;
+  }
 
-  std::unique_ptr<runtime_val> clone() const override {
-    return std::make_unique<nil_val>(*this);
+  std::vector<string_obj*> dead{obj};
+  while (!dead.empty()) {
+    string_obj* node = dead.back();
+    dead.pop_back();
+    if (node->is_rope()) {
+      for (string_obj* child : {node->left, node->right}) {
+        if (child->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) dead.push_back(child);
+      }
+    }
+    delete node;
   }
-};
+}
 
-struct number_val: public runtime_val {
-  double value;
-  explicit number_val(double v = 0.0): runtime_val(NUMBER), value(v) {}
+// rope -> flat text, children released once their bytes are copied
+inline const std::string& flatten(string_obj* root) {
+  if (!root->is_rope()) return root->text;
+
+  std::string out;
+  out.reserve(root->length);
+  std::vector<const string_obj*> pending{root->right, root->left}; // left on top
+  while (!pending.empty()) {
+    const string_obj* node = pending.back();
+    pending.pop_back();
+    if (node->is_rope()) {
+      pending.push_back(node->right);
+      pending.push_back(node->left);
+    } else {
+      out += node->text;
+    }
+  }
 
-  std::unique_ptr<runtime_val> clone() const override {
-    return std::make_unique<number_val>(*this);
+  string_obj* l = root->left;
+  string_obj* r = root->right;
+  root->text = std::move(out);
+  root->left = root->right = nullptr;
+  release(l);
+  release(r);
+  return root->text;
+}
+
+/*
+ * every runtime value, passed around by value -- 16 bytes, tag + payload
+ * numbers, bools and nil live inline so arithmetic never hits the allocator
+ * strings (and whatever object types come later) sit behind a refcounted
+ * pointer: reading a variable bumps a count instead of copying the text,
+ * and edit_str() copies only when the payload is actually shared
+ * */
+struct value {
+  value_type type = NIL;
+  union {
+    double number = 0.0;
+    bool boolean;
+    string_obj* string;
+  };
+
+  value() = default;
+
+  value(const value& other) : type(other.type), number(other.number) {
+    if (type == STR) string->refs.fetch_add(1, std::memory_order_relaxed);
   }
-};
 
-struct bool_val: public runtime_val {
-  bool value;
-  explicit bool_val(bool v = true): runtime_val(BOOL), value(v) {}
+  // payloads are all 8 bytes or less, moving the double moves any of them
+  value(value&& other) noexcept : type(other.type), number(other.number) {
+    other.type = NIL;
+  }
 
-  std::unique_ptr<runtime_val> clone() const override {
-    return std::make_unique<bool_val>(*this);
+  value& operator=(value other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~value() {
+    if (type == STR) release(string);
   }
-};
 
-struct str_val: public runtime_val {
-  std::string value;
-  explicit str_val(std::string v = ""): runtime_val(STR), value(v) {}
+  void swap(value& other) noexcept {
+    std::swap(type, other.type);
+    std::swap(number, other.number);
+  }
 
-  std::unique_ptr<runtime_val> clone() const override {
-    return std::make_unique<str_val>(*this);
+  // ropes flatten here, on first read
+  const std::string& str() const {
+    return flatten(string);
+  }
+
+  // copy on write -- detach from other holders before handing out the text
+  std::string& edit_str() {
+    flatten(string);
+    if (string->refs.load(std::memory_order_acquire) != 1) {
+      auto* own = new string_obj(string->text);
+      value old = std::move(*this); // drops our reference on the way out
+      type = STR;
+      string = own;
+    }
+    return string->text;
   }
 };
 
-using rtpoint = std::unique_ptr<runtime_val>;
+static_assert(sizeof(value) == 16, "value should stay two words");
 
 // Factory functions
-inline rtpoint make_nil() {
-  return std::make_unique<nil_val>();
+inline value make_nil() {
+  return value();
+}
+
+inline value make_number(double val) {
+  value v;
+  v.type = NUMBER;
+  v.number = val;
+  return v;
 }
 
-inline rtpoint make_number(double val) {
-  return std::make_unique<number_val>(val);
+inline value make_bool(bool val) {
+  value v;
+  v.type = BOOL;
+  v.boolean = val;
+  return v;
 }
 
-inline rtpoint make_bool(bool val) {
-  return std::make_unique<bool_val>(val);
+inline value make_string(std::string val) {
+  value v;
+  v.type = STR;
+  v.string = new string_obj(std::move(val));
+  return v;
 }
 
-inline rtpoint make_string(std::string val) {
-  return std::make_unique<str_val>(std::move(val));
+// left + right without copying either, see string_obj
+inline value make_rope(string_obj* left, string_obj* right) {
+  value v;
+  v.type = STR;
+  v.string = new string_obj(left, right);
+  return v;
 }
 
-inline bool is_nil(const runtime_val* val) {
-  return val && val->type == NIL;
+inline bool is_nil(const value& val) {
+  return val.type == NIL;
 }
 
-inline bool is_number(const runtime_val* val) {
-  return val && val->type == NUMBER;
+inline bool is_number(const value& val) {
+  return val.type == NUMBER;
 }
 
-inline bool is_truthy(const runtime_val* val) {
-  if (!val) return false;
-  if (val->type == NIL) return false;
-  if (val->type == BOOL) return static_cast<const bool_val*>(val)->value;
+inline bool is_truthy(const value& val) {
+  if (val.type == NIL) return false;
+  if (val.type == BOOL) return val.boolean;
   return true;
 }
 
 }
 
 #endif
-
-
@@ -0,0 +1,28 @@
+#ifndef FRAGMENT_HPP
+#define FRAGMENT_HPP
+
+#include <cstdint>
+
+#include "interpreter/values.hpp"
+#include "symtable/environment.hpp"
+
+namespace jit {
+
+// native code for one numeric subtree: reads number slots of the current
+// frame, writes the result, returns 0 -- anything else means deoptimize
+using native_fn = int (*)(const interpreter::value* slots, double* out);
+
+struct fragment {
+  native_fn fn;
+  uint32_t slots_needed; // highest slot read + 1, checked before entering
+};
+
+// false sends the caller back to the tree walker for this subtree
+inline bool enter(const fragment* code, symtable::environment* env, double& out) {
+  if (env->slot_count() < code->slots_needed) return false;
+  return code->fn(env->slot_data(), &out) == 0;
+}
+
+}
+
+#endif
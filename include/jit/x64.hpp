@@ -0,0 +1,302 @@
+#ifndef X64_HPP
+#define X64_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "interpreter/values.hpp"
+#include "jit/fragment.hpp"
+#include "parser/node_types.hpp"
+
+// native code needs mmap/mprotect and the SysV calling convention
+// build with -DMEOW_NO_JIT to leave it out even there
+#if defined(__linux__) && defined(__x86_64__) && !defined(MEOW_NO_JIT)
+#define MEOW_HAS_JIT 1
+#include <sys/mman.h>
+#endif
+
+namespace jit {
+
+#ifdef MEOW_HAS_JIT
+
+// the generated loads hard code these
+static_assert(sizeof(interpreter::value) == 16, "jit expects 16 byte values");
+static_assert(offsetof(interpreter::value, number) == 8, "jit expects the payload at offset 8");
+static_assert(sizeof(interpreter::value_type) == 4, "jit compares the tag as a dword");
+
+/*
+ * x86-64 SSE2 code for the purely numeric parts of a resolved AST
+ * a fragment covers a maximal subtree of + - * / % whose leaves are number
+ * literals or depth 0 slots. xmm0..xmm14 act as a register stack (subtrees
+ * needing more are split up), xmm15 is scratch. anything the
+ * fast path can't promise -- a non number slot, division by zero, a mod
+ * operand outside int range -- jumps to a shared exit that returns 1 and the
+ * tree walker redoes the subtree, errors and all. the subtree is pure so
+ * doing it twice is invisible
+ * */
+class code_cache {
+public:
+  code_cache() = default;
+  code_cache(const code_cache&) = delete;
+  code_cache& operator=(const code_cache&) = delete;
+
+  ~code_cache() {
+    if (region) munmap(region, region_size);
+  }
+
+  // fills in binary_exp::native across the program, returns how many fragments
+  size_t compile(parser::program& prgrm) {
+    if (region) throw std::runtime_error("JIT: code_cache already holds a program");
+
+    std::vector<pending> found;
+    for (auto* stmt : prgrm.body) {
+      take(stmt, collect(stmt, found), found);
+    }
+    if (found.empty()) return 0;
+
+    region_size = (code.size() + 4095) & ~size_t(4095);
+    void* mem = mmap(nullptr, region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return 0; // no native code, the interpreter still works
+    std::memcpy(mem, code.data(), code.size());
+    if (mprotect(mem, region_size, PROT_READ | PROT_EXEC) != 0) {
+      munmap(mem, region_size);
+      return 0;
+    }
+    region = mem;
+
+    fragments = std::make_unique<fragment[]>(found.size());
+    for (size_t i = 0; i < found.size(); i++) {
+      fragments[i].fn = reinterpret_cast<native_fn>(static_cast<uint8_t*>(region) + found[i].offset);
+      fragments[i].slots_needed = found[i].slots_needed;
+      found[i].node->native = &fragments[i];
+    }
+    count = found.size();
+    return count;
+  }
+
+  size_t fragment_count() const { return count; }
+  size_t code_bytes() const { return code.size(); }
+
+private:
+  static constexpr int max_regs = 15;     // xmm0..xmm14
+  static constexpr uint8_t scratch = 15;  // xmm15
+
+  struct pending {
+    parser::binary_exp* node;
+    size_t offset;
+    uint32_t slots_needed;
+  };
+
+  std::vector<uint8_t> code; // every fragment, copied into the region at the end
+  std::vector<size_t> deopt_patches;
+  std::vector<uint32_t> checked; // slots whose tag this fragment already tested
+  uint32_t slots_needed = 0;
+  void* region = nullptr;
+  size_t region_size = 0;
+  std::unique_ptr<fragment[]> fragments;
+  size_t count = 0;
+
+  // what a subtree costs as one fragment -- regs 0 means it can't be one
+  struct shape {
+    int regs;
+    int ops;
+  };
+
+  bool worth_it(const shape& sh) const {
+    return sh.regs && sh.regs <= max_regs && sh.ops >= 2;
+  }
+
+  /*
+   * post order, so each node is looked at once: a compilable subtree is
+   * handed up to its parent, and only emitted by the first ancestor that
+   * can't absorb it (or the statement root)
+   * */
+  shape collect(parser::statement* node, std::vector<pending>& found) {
+    switch (node->kind) {
+      case parser::NUMERIC_LITERAL:
+        return {1, 0};
+
+      case parser::IDENTIFIER: {
+        auto addr = static_cast<const parser::identifier*>(node)->addr;
+        return {addr.resolved() && addr.depth == 0 && addr.slot < (1u << 27) ? 1 : 0, 0};
+      }
+
+      case parser::VAR_DEC: {
+        auto* decl = static_cast<parser::var_dec*>(node);
+        if (decl->type) take(decl->type, collect(decl->type, found), found);
+        return {0, 0};
+      }
+
+      case parser::BINARY_EXP: {
+        auto* bin = static_cast<parser::binary_exp*>(node);
+        shape l = collect(bin->left, found);
+        shape r = collect(bin->right, found);
+        // left first on a register stack: the right side sits one above
+        shape out{std::max(l.regs, r.regs + 1), l.ops + r.ops + 1};
+        if (parser::is_arithmetic(bin->op) && l.regs && r.regs && out.regs <= max_regs) {
+          return out;
+        }
+        take(bin->left, l, found);
+        take(bin->right, r, found);
+        return {0, 0};
+      }
+
+      default:
+        return {0, 0};
+    }
+  }
+
+  void take(parser::statement* node, const shape& sh, std::vector<pending>& found) {
+    if (!worth_it(sh)) return;
+    auto* bin = static_cast<parser::binary_exp*>(node);
+    found.push_back({bin, code.size(), 0});
+    found.back().slots_needed = emit_fragment(bin);
+  }
+
+  uint32_t emit_fragment(const parser::binary_exp* bin) {
+    deopt_patches.clear();
+    checked.clear();
+    slots_needed = 0;
+
+    emit_node(bin, 0);
+    bytes({0xF2, 0x0F, 0x11, 0x06}); // movsd [rsi], xmm0
+    bytes({0x31, 0xC0, 0xC3});       // xor eax, eax; ret
+
+    const size_t deopt = code.size();
+    bytes({0xB8, 0x01, 0x00, 0x00, 0x00, 0xC3}); // mov eax, 1; ret
+    for (size_t at : deopt_patches) {
+      put_i32(at, static_cast<int32_t>(deopt - (at + 4)));
+    }
+    return slots_needed;
+  }
+
+  // leaves node's value in xmm<reg>, clobbers only higher registers
+  void emit_node(const parser::statement* node, uint8_t reg) {
+    if (node->kind == parser::NUMERIC_LITERAL) {
+      double num = static_cast<const parser::numeric_literal*>(node)->value;
+      uint64_t bits;
+      std::memcpy(&bits, &num, sizeof(bits));
+      bytes({0x48, 0xB8}); // mov rax, imm64
+      for (int i = 0; i < 8; i++) byte(static_cast<uint8_t>(bits >> (i * 8)));
+      bytes({0x66, static_cast<uint8_t>(0x48 | (reg >= 8 ? 0x04 : 0)), 0x0F, 0x6E,
+             static_cast<uint8_t>(0xC0 | ((reg & 7) << 3))}); // movq xmm<reg>, rax
+      return;
+    }
+
+    if (node->kind == parser::IDENTIFIER) {
+      uint32_t slot = static_cast<const parser::identifier*>(node)->addr.slot;
+      if (slot + 1 > slots_needed) slots_needed = slot + 1;
+      const int32_t disp = static_cast<int32_t>(slot * sizeof(interpreter::value));
+
+      // a fragment can't change a slot's type, one check per slot is enough
+      if (std::find(checked.begin(), checked.end(), slot) == checked.end()) {
+        checked.push_back(slot);
+        byte(0x83); // cmp dword [rdi + disp], NUMBER
+        rdi_operand(7, disp);
+        byte(interpreter::NUMBER);
+        deopt_if(0x85); // jne
+      }
+
+      byte(0xF2);
+      if (reg >= 8) byte(0x44); // REX.R
+      bytes({0x0F, 0x10}); // movsd xmm<reg>, [rdi + disp + 8]
+      rdi_operand(reg & 7, disp + 8);
+      return;
+    }
+
+    auto* bin = static_cast<const parser::binary_exp*>(node);
+    const uint8_t l = reg, r = reg + 1;
+    emit_node(bin->left, l);
+    emit_node(bin->right, r);
+
+    switch (bin->op) {
+      case parser::OP_ADD: sse(0xF2, 0x58, l, r); break; // addsd
+      case parser::OP_SUB: sse(0xF2, 0x5C, l, r); break; // subsd
+      case parser::OP_MUL: sse(0xF2, 0x59, l, r); break; // mulsd
+      case parser::OP_DIV:
+        sse(0x66, 0x57, scratch, scratch); // xorpd xmm15, xmm15
+        sse(0x66, 0x2E, r, scratch);       // ucomisd rhs, 0.0 -- also true for NaN
+        deopt_if(0x84);                    // je
+        sse(0xF2, 0x5E, l, r);             // divsd
+        break;
+      case parser::OP_MOD:
+        emit_mod(l, r);
+        break;
+      default:
+        throw std::runtime_error("JIT: operator is not arithmetic");
+    }
+  }
+
+  // same truncations as num_binary_op, out of range ints (0x80000000) deopt
+  void emit_mod(uint8_t l, uint8_t r) {
+    sse(0xF2, 0x2C, 1, r);                        // cvttsd2si ecx, rhs
+    bytes({0x85, 0xC9});                          // test ecx, ecx
+    deopt_if(0x84);                               // je -- mod by zero
+    bytes({0x81, 0xF9, 0x00, 0x00, 0x00, 0x80});  // cmp ecx, INT_MIN
+    deopt_if(0x84);
+    sse(0xF2, 0x2C, 0, l);                        // cvttsd2si eax, lhs
+    bytes({0x3D, 0x00, 0x00, 0x00, 0x80});        // cmp eax, INT_MIN
+    deopt_if(0x84);
+    bytes({0x99, 0xF7, 0xF9});                    // cdq; idiv ecx
+    sse(0xF2, 0x2A, l, 2);                        // cvtsi2sd lhs, edx
+  }
+
+  // prefix [REX] 0F op modrm(reg, rm) with both operands registers
+  void sse(uint8_t prefix, uint8_t op, uint8_t reg, uint8_t rm) {
+    byte(prefix);
+    uint8_t rex = 0x40 | (reg >= 8 ? 0x04 : 0) | (rm >= 8 ? 0x01 : 0);
+    if (rex != 0x40) byte(rex);
+    bytes({0x0F, op, static_cast<uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7))});
+  }
+
+  // modrm + displacement for [rdi + disp], disp8 when it fits
+  void rdi_operand(uint8_t reg, int32_t disp) {
+    if (disp < 128) {
+      byte(static_cast<uint8_t>(0x47 | (reg << 3)));
+      byte(static_cast<uint8_t>(disp));
+    } else {
+      byte(static_cast<uint8_t>(0x87 | (reg << 3)));
+      i32(disp);
+    }
+  }
+
+  // jcc rel32 to the fragment's deopt exit, patched in emit_fragment
+  void deopt_if(uint8_t cc) {
+    bytes({0x0F, cc});
+    deopt_patches.push_back(code.size());
+    i32(0);
+  }
+
+  void byte(uint8_t b) { code.push_back(b); }
+
+  void bytes(std::initializer_list<uint8_t> bs) { code.insert(code.end(), bs); }
+
+  void i32(int32_t v) {
+    for (int i = 0; i < 4; i++) byte(static_cast<uint8_t>(static_cast<uint32_t>(v) >> (i * 8)));
+  }
+
+  void put_i32(size_t at, int32_t v) {
+    for (int i = 0; i < 4; i++) code[at + i] = static_cast<uint8_t>(static_cast<uint32_t>(v) >> (i * 8));
+  }
+};
+
+#else
+
+// no native backend on this platform -- everything stays in the interpreter
+class code_cache {
+public:
+  size_t compile(parser::program&) { return 0; }
+  size_t fragment_count() const { return 0; }
+  size_t code_bytes() const { return 0; }
+};
+
+#endif
+
+}
+
+#endif
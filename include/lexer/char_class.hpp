@@ -0,0 +1,84 @@
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+
+#include <array>
+
+#include "lexer/token.hpp"
+
+namespace lexer {
+
+// what scan_token does with a leading char
+enum char_class : unsigned char {
+  CC_INVALID,  // unexpected character
+  CC_SPACE,    // ignored
+  CC_NEWLINE,  // ignored, bumps line
+  CC_DIGIT,    // number literal
+  CC_ALPHA,    // identifier / keyword
+  CC_QUOTE,    // string literal
+  CC_COMMENT,  // $ comment
+  CC_SINGLE,   // one char token -> single
+  CC_EQ_PAIR,  // single, or paired when followed by '='
+};
+
+struct char_info {
+  char_class cls = CC_INVALID;
+  bool iden = false;            // may continue an identifier
+  token_type single = UNKOWN;
+  token_type paired = UNKOWN;   // CC_EQ_PAIR only
+};
+
+// ascii only, independent of the C locale
+constexpr std::array<char_info, 256> build_char_table(){
+  std::array<char_info, 256> table{};
+  auto set = [&](char c, char_class cls, token_type single = UNKOWN, token_type paired = UNKOWN){
+    auto& info = table[static_cast<unsigned char>(c)];
+    info.cls = cls;
+    info.single = single;
+    info.paired = paired;
+  };
+
+  for(char c : {' ', '\t', '\r', '\b'}) set(c, CC_SPACE);
+  set('\n', CC_NEWLINE);
+  set('"', CC_QUOTE);
+  set('$', CC_COMMENT);
+
+  set('(', CC_SINGLE, LPAREN);
+  set(')', CC_SINGLE, RPAREN);
+  set('{', CC_SINGLE, LBRACE);
+  set('}', CC_SINGLE, RBRACE);
+  set(',', CC_SINGLE, COMMA);
+  set('*', CC_SINGLE, MULT);
+  set('/', CC_SINGLE, DIV);
+  set('+', CC_SINGLE, PLUS);
+  set('-', CC_SINGLE, MINUS);
+  set('.', CC_SINGLE, DOT);
+  set('%', CC_SINGLE, MOD);
+  set('^', CC_SINGLE, POW);
+  set(';', CC_SINGLE, LEND);
+
+  set('!', CC_EQ_PAIR, NOT, NOT_EQ);
+  set('=', CC_EQ_PAIR, ASSIGN, EQ_EQ);
+  set('<', CC_EQ_PAIR, LESS, LESS_EQ);
+  set('>', CC_EQ_PAIR, GREATER, GREATER_EQ);
+
+  for(char c = '0'; c <= '9'; c++) set(c, CC_DIGIT);
+  for(char c = 'a'; c <= 'z'; c++) set(c, CC_ALPHA);
+  for(char c = 'A'; c <= 'Z'; c++) set(c, CC_ALPHA);
+
+  for(auto& info : table){
+    info.iden = info.cls == CC_DIGIT || info.cls == CC_ALPHA;
+  }
+  table[static_cast<unsigned char>('_')].iden = true; // continues, can't start
+
+  return table;
+}
+
+inline constexpr std::array<char_info, 256> char_table = build_char_table();
+
+constexpr const char_info& classify(char c){
+  return char_table[static_cast<unsigned char>(c)];
+}
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+#include "lexer/token.hpp"
+
+namespace lexer {
+
+struct keyword {
+  std::string_view text;
+  token_type type = IDENTIFIER;
+};
+
+// one line per keyword -- the perfect hash below is rebuilt at compile time
+inline constexpr keyword keyword_list[] = {
+  // Keywords
+  {"new", VAR},
+  {"del", DEL},
+  {"mut", MUT},
+  {"nil", NIL},
+  // {"is", ASSIGN},
+  // {"check", IF},
+  {"or", OR},
+  {"and", AND},
+  // {"nah", NOT},
+  // {"not", NOT},
+  // {"otherwise", ELSE},
+  // {"loop", WHILE},
+  // {"fun", FUN},
+  // {"meow", MEOW},
+  // {"result", RETURN},
+  // {"nap", BREAK},
+  // {"pursue", CONTINUE},
+  // {"fetch", IMPORT},
+};
+
+namespace kw_detail {
+
+constexpr std::size_t COUNT = std::size(keyword_list);
+
+// fnv-1a, seeded -- keywords are short so hashing every byte is cheap
+constexpr uint32_t hash(std::string_view s, uint32_t seed){
+  uint32_t h = 2166136261u ^ seed;
+  for(char c : s){
+    h ^= static_cast<unsigned char>(c);
+    h *= 16777619u;
+  }
+  return h ^ (h >> 16); // low bits alone barely depend on the seed
+}
+
+constexpr std::size_t table_size(){
+  std::size_t n = 8;
+  while(n < COUNT * 2) n <<= 1;
+  return n;
+}
+
+constexpr std::size_t SIZE = table_size();
+
+constexpr bool collides(uint32_t seed){
+  bool used[SIZE] = {};
+  for(const auto& kw : keyword_list){
+    std::size_t slot = hash(kw.text, seed) & (SIZE - 1);
+    if(used[slot]) return true;
+    used[slot] = true;
+  }
+  return false;
+}
+
+constexpr uint32_t NO_SEED = UINT32_MAX;
+
+constexpr uint32_t find_seed(){
+  for(uint32_t seed = 0; seed < 100000; seed++){
+    if(!collides(seed)) return seed;
+  }
+  return NO_SEED;
+}
+
+constexpr uint32_t SEED = find_seed();
+static_assert(SEED != NO_SEED, "no perfect hash seed for keyword_list, grow SIZE");
+
+constexpr std::array<keyword, SIZE> build(){
+  std::array<keyword, SIZE> table{};
+  for(const auto& kw : keyword_list){
+    table[hash(kw.text, SEED) & (SIZE - 1)] = kw;
+  }
+  return table;
+}
+
+constexpr std::array<keyword, SIZE> TABLE = build();
+
+constexpr std::size_t MIN_LEN = [](){
+  std::size_t n = SIZE;
+  for(const auto& kw : keyword_list) n = kw.text.size() < n ? kw.text.size() : n;
+  return n;
+}();
+
+constexpr std::size_t MAX_LEN = [](){
+  std::size_t n = 0;
+  for(const auto& kw : keyword_list) n = kw.text.size() > n ? kw.text.size() : n;
+  return n;
+}();
+
+}
+
+// keyword type of a lexeme, IDENTIFIER if it isn't one -- one probe, no allocation
+constexpr token_type keyword_type(std::string_view lexeme){
+  using namespace kw_detail;
+  if(lexeme.size() < MIN_LEN || lexeme.size() > MAX_LEN) return IDENTIFIER;
+
+  const keyword& slot = TABLE[hash(lexeme, SEED) & (SIZE - 1)];
+  return slot.text == lexeme ? slot.type : IDENTIFIER;
+}
+
+static_assert(keyword_type("mut") == MUT, "keyword table broken");
+static_assert(keyword_type("mutable") == IDENTIFIER, "keyword table broken");
+
+}
+
+#endif
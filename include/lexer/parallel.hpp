@@ -0,0 +1,129 @@
+#ifndef PARALLEL_LEXER_HPP
+#define PARALLEL_LEXER_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <vector>
+
+#include "lexer/tokenizer.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace lexer {
+
+// below this much text per thread the split costs more than it saves
+inline constexpr size_t MIN_CHUNK = 1 << 16;
+
+/*
+ * chunk starts for a parallel scan -- about size / chunks apart, each one
+ * just past a newline. every token except a string ends before the next
+ * newline ($ comments stop at it too), so a line start is a clean lexer
+ * state unless a string is open across it -- scan_tokens_parallel checks that
+ * */
+inline std::vector<size_t> split_lines(std::string_view src, size_t chunks){
+  std::vector<size_t> starts{0};
+  for(size_t i = 1; i < chunks; i++){
+    size_t target = src.size() / chunks * i;
+    if(target < starts.back()) continue;
+    const void* nl = std::memchr(src.data() + target, '\n', src.size() - target);
+    if(!nl) break;
+    size_t at = static_cast<const char*>(nl) - src.data() + 1;
+    if(at >= src.size()) break;
+    if(at > starts.back()) starts.push_back(at);
+  }
+  return starts;
+}
+
+/*
+ * scan_tokens on a pool -- same tokens, lines and errors as the serial scan
+ * chunks are lexed on their own with lines counted from 1, then shifted by the
+ * newlines of every chunk before them. a chunk that throws either hit a real
+ * error or ended inside a string, so its start was the last boundary proven
+ * safe: its tokens and everything after are redone serially from there, which
+ * also reports the error exactly as scan_tokens would
+ * STREAM tokenizers have no whole buffer to split and just scan serially
+ * */
+inline void scan_tokens_parallel(tokenizer& tok_obj, utils::thread_pool& pool){
+  const std::string_view src = tok_obj.source.substr(tok_obj.pos);
+  const size_t chunks = std::min(pool.size(), src.size() / MIN_CHUNK);
+  if(tok_obj.reader || chunks < 2){
+    scan_tokens(tok_obj);
+    return;
+  }
+
+  const std::vector<size_t> starts = split_lines(src, chunks);
+  struct chunk {
+    token_list tokens;
+    int newlines = 0;
+    std::exception_ptr failure;
+  };
+  std::vector<chunk> parts(starts.size());
+  symtable::interner& symbols = symtable::current_interner(); // the caller's, maybe a run's
+
+  pool.for_each(parts.size(), [&](size_t i){
+    symtable::interner_scope use(symbols);
+    size_t end = i + 1 < starts.size() ? starts[i + 1] : src.size();
+    tokenizer part(tok_obj.buffer);
+    part.source = src.substr(starts[i], end - starts[i]); // views stay inside the shared buffer
+    part.max = static_cast<int>(part.source.size());
+    try {
+      scan_remaining(part);
+    } catch(...) {
+      parts[i].failure = std::current_exception();
+    }
+    parts[i].tokens = std::move(part.tokens);
+    // a comment running into max swallows its newline uncounted (fine at EOF,
+    // not at a chunk end), so only the last chunk can trust its line count
+    parts[i].newlines = end == src.size() ? part.line - 1
+                      : static_cast<int>(std::count(part.source.begin(), part.source.end(), '\n'));
+  });
+
+  // accept chunks up to the first one that failed
+  size_t accepted = 0, total = tok_obj.tokens.size();
+  std::vector<size_t> offsets;
+  std::vector<int> line_base;
+  int lines = tok_obj.line - 1;
+  for(; accepted < parts.size() && !parts[accepted].failure; accepted++){
+    offsets.push_back(total);
+    line_base.push_back(lines);
+    total += parts[accepted].tokens.size();
+    lines += parts[accepted].newlines;
+  }
+
+  tok_obj.tokens.resize(total);
+  pool.for_each(accepted, [&](size_t i){
+    token* out = tok_obj.tokens.data() + offsets[i];
+    for(auto& tok : parts[i].tokens){
+      *out = tok;
+      out->line += line_base[i];
+      out++;
+    }
+  });
+
+  tok_obj.line = lines + 1;
+  if(accepted < parts.size()){
+    tok_obj.pos = tok_obj.start = static_cast<int>(src.data() - tok_obj.source.data() + starts[accepted]);
+    scan_tokens(tok_obj);
+    return;
+  }
+
+  tok_obj.pos = tok_obj.start = tok_obj.max;
+  tok_obj.add_tok(END_OF_FILE);
+}
+
+// scan_tokens_parallel, but a lex error is handed back instead of thrown --
+// tokens then hold everything before it (no END_OF_FILE), so a caller can
+// still report something earlier in the source first, see parser/parallel.hpp
+inline std::exception_ptr scan_tokens_until_error(tokenizer& tok_obj, utils::thread_pool& pool){
+  try {
+    scan_tokens_parallel(tok_obj, pool);
+  } catch(...) {
+    return std::current_exception(); // nothing is added after the bad char
+  }
+  return nullptr;
+}
+
+}
+
+#endif
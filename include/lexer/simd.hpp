@@ -0,0 +1,301 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstdint>
+
+#include "lexer/char_class.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MEOW_SIMD_X86 1
+#endif
+
+/*
+ * run kernels for the lexer -- each returns the first byte in [p, end)
+ * that is NOT part of the run (or end), kernels that can cross lines
+ * add the newlines they passed to `lines`
+ *
+ * SSE2 / AVX2 versions classify 16 / 32 bytes per step, picked once at
+ * runtime, scalar versions handle the tail and non x86 builds
+ * */
+namespace lexer::simd {
+
+enum class level { SCALAR, SSE2, AVX2 };
+
+// scalar classes come from the lexer's char table
+inline bool is_space(char c){
+  char_class cls = classify(c).cls;
+  return cls == CC_SPACE || cls == CC_NEWLINE;
+}
+
+inline bool is_digit(char c){
+  return classify(c).cls == CC_DIGIT;
+}
+
+inline bool is_iden(char c){
+  return classify(c).iden;
+}
+
+// ---- scalar ------------------------------------------------------------
+
+inline const char* skip_space_scalar(const char* p, const char* end, int& lines){
+  for(; p < end && is_space(*p); p++) lines += *p == '\n';
+  return p;
+}
+
+inline const char* iden_end_scalar(const char* p, const char* end){
+  while(p < end && is_iden(*p)) p++;
+  return p;
+}
+
+inline const char* digit_end_scalar(const char* p, const char* end){
+  while(p < end && is_digit(*p)) p++;
+  return p;
+}
+
+inline const char* find_quote_scalar(const char* p, const char* end, int& lines){
+  for(; p < end && *p != '"'; p++) lines += *p == '\n';
+  return p;
+}
+
+inline const char* find_comment_end_scalar(const char* p, const char* end){
+  while(p < end && *p != '\n' && *p != '$') p++;
+  return p;
+}
+
+#ifdef MEOW_SIMD_X86
+// ---- sse2 (x86-64 baseline) --------------------------------------------
+
+// bytes in [lo, hi] -- bias so lo maps to -128, then one signed compare
+inline __m128i in_range16(__m128i v, char lo, char hi){
+  __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+  return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + (hi - lo) + 1)));
+}
+
+inline __m128i space_mask16(__m128i v){
+  __m128i m = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+  m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\b')));
+  return _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+}
+
+inline __m128i iden_mask16(__m128i v){
+  __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20)); // fold A-Z onto a-z
+  __m128i m = in_range16(lower, 'a', 'z');
+  m = _mm_or_si128(m, in_range16(v, '0', '9'));
+  return _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+}
+
+// newlines among the first n bytes of a block
+inline int newlines_before(uint32_t newline_bits, int n){
+  uint32_t below = n >= 32 ? ~0u : (1u << n) - 1;
+  return __builtin_popcount(newline_bits & below);
+}
+
+inline const char* skip_space_sse2(const char* p, const char* end, int& lines){
+  for(; end - p >= 16; p += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t stop = ~_mm_movemask_epi8(space_mask16(v)) & 0xFFFF;
+    uint32_t nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    if(stop){
+      int n = __builtin_ctz(stop);
+      lines += newlines_before(nl, n);
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+  }
+  return skip_space_scalar(p, end, lines);
+}
+
+inline const char* iden_end_sse2(const char* p, const char* end){
+  for(; end - p >= 16; p += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t stop = ~_mm_movemask_epi8(iden_mask16(v)) & 0xFFFF;
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return iden_end_scalar(p, end);
+}
+
+inline const char* digit_end_sse2(const char* p, const char* end){
+  for(; end - p >= 16; p += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t stop = ~_mm_movemask_epi8(in_range16(v, '0', '9')) & 0xFFFF;
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return digit_end_scalar(p, end);
+}
+
+inline const char* find_quote_sse2(const char* p, const char* end, int& lines){
+  for(; end - p >= 16; p += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    uint32_t stop = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    uint32_t nl = _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    if(stop){
+      int n = __builtin_ctz(stop);
+      lines += newlines_before(nl, n);
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+  }
+  return find_quote_scalar(p, end, lines);
+}
+
+inline const char* find_comment_end_sse2(const char* p, const char* end){
+  for(; end - p >= 16; p += 16){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('$')));
+    uint32_t stop = _mm_movemask_epi8(m);
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return find_comment_end_scalar(p, end);
+}
+
+// ---- avx2 (runtime checked) --------------------------------------------
+
+#define MEOW_AVX2 __attribute__((target("avx2,popcnt,bmi")))
+
+MEOW_AVX2 inline __m256i in_range32(__m256i v, char lo, char hi){
+  __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + (hi - lo) + 1)), shifted);
+}
+
+MEOW_AVX2 inline __m256i space_mask32(__m256i v){
+  __m256i m = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')));
+  m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\b')));
+  return _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+}
+
+MEOW_AVX2 inline __m256i iden_mask32(__m256i v){
+  __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+  __m256i m = in_range32(lower, 'a', 'z');
+  m = _mm256_or_si256(m, in_range32(v, '0', '9'));
+  return _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+}
+
+MEOW_AVX2 inline uint32_t movemask32(__m256i m){
+  return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+MEOW_AVX2 inline const char* skip_space_avx2(const char* p, const char* end, int& lines){
+  for(; end - p >= 32; p += 32){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t stop = ~movemask32(space_mask32(v));
+    uint32_t nl = movemask32(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+    if(stop){
+      int n = __builtin_ctz(stop);
+      lines += newlines_before(nl, n);
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+  }
+  return skip_space_sse2(p, end, lines);
+}
+
+MEOW_AVX2 inline const char* iden_end_avx2(const char* p, const char* end){
+  for(; end - p >= 32; p += 32){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t stop = ~movemask32(iden_mask32(v));
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return iden_end_sse2(p, end);
+}
+
+MEOW_AVX2 inline const char* digit_end_avx2(const char* p, const char* end){
+  for(; end - p >= 32; p += 32){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t stop = ~movemask32(in_range32(v, '0', '9'));
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return digit_end_sse2(p, end);
+}
+
+MEOW_AVX2 inline const char* find_quote_avx2(const char* p, const char* end, int& lines){
+  for(; end - p >= 32; p += 32){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    uint32_t stop = movemask32(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+    uint32_t nl = movemask32(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+    if(stop){
+      int n = __builtin_ctz(stop);
+      lines += newlines_before(nl, n);
+      return p + n;
+    }
+    lines += __builtin_popcount(nl);
+  }
+  return find_quote_sse2(p, end, lines);
+}
+
+MEOW_AVX2 inline const char* find_comment_end_avx2(const char* p, const char* end){
+  for(; end - p >= 32; p += 32){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')));
+    uint32_t stop = movemask32(m);
+    if(stop) return p + __builtin_ctz(stop);
+  }
+  return find_comment_end_sse2(p, end);
+}
+
+#undef MEOW_AVX2
+#endif // MEOW_SIMD_X86
+
+// ---- dispatch ------------------------------------------------------------
+
+struct kernels {
+  level lvl;
+  const char* (*skip_space)(const char*, const char*, int&);
+  const char* (*iden_end)(const char*, const char*);
+  const char* (*digit_end)(const char*, const char*);
+  const char* (*find_quote)(const char*, const char*, int&);
+  const char* (*find_comment_end)(const char*, const char*);
+};
+
+inline level best_level(){
+#ifdef MEOW_SIMD_X86
+  if(__builtin_cpu_supports("avx2")) return level::AVX2;
+  return level::SSE2;
+#else
+  return level::SCALAR;
+#endif
+}
+
+// table for `lvl`, clamped to what this cpu supports
+inline kernels make_kernels(level lvl){
+  if(lvl > best_level()) lvl = best_level();
+
+  switch(lvl){
+#ifdef MEOW_SIMD_X86
+  case level::AVX2:
+    return {lvl, skip_space_avx2, iden_end_avx2, digit_end_avx2, find_quote_avx2, find_comment_end_avx2};
+  case level::SSE2:
+    return {lvl, skip_space_sse2, iden_end_sse2, digit_end_sse2, find_quote_sse2, find_comment_end_sse2};
+#endif
+  default:
+    return {level::SCALAR, skip_space_scalar, iden_end_scalar, digit_end_scalar, find_quote_scalar, find_comment_end_scalar};
+  }
+}
+
+// kernels the lexer uses -- best available unless overridden with use()
+inline kernels& active(){
+  static kernels k = make_kernels(best_level());
+  return k;
+}
+
+inline void use(level lvl){
+  active() = make_kernels(lvl);
+}
+
+inline const char* level_name(level lvl){
+  switch(lvl){
+  case level::AVX2: return "avx2";
+  case level::SSE2: return "sse2";
+  default:          return "scalar";
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef SOURCE_HPP
+#define SOURCE_HPP
+
+#include <climits>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MEOW_HAS_MMAP 1
+#endif
+
+namespace lexer {
+
+// how new_tokenizer gets the file into memory
+enum class load_mode {
+  READ,   // one read into an owned string
+  MMAP,   // read-only mapping, lexed in place
+  STREAM, // CHUNK sized reads, only the unscanned tail resident
+};
+
+// source text -- every token views into this, so it must outlive them
+class source_buffer {
+public:
+  virtual ~source_buffer() = default;
+  virtual std::string_view view() const = 0;
+};
+
+using source_ptr = std::shared_ptr<const source_buffer>;
+
+class owned_source :public source_buffer {
+public:
+  explicit owned_source(std::string txt) : text(std::move(txt)) {}
+
+  std::string_view view() const override {
+    return text;
+  }
+
+private:
+  std::string text;
+};
+
+inline source_ptr make_source(std::string text){
+  return std::make_shared<const owned_source>(std::move(text));
+}
+
+// single read sized from the file -- no stringstream round trip
+inline source_ptr read_source(const std::string& file_name){
+  std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+  if(!file.is_open()){
+    throw std::runtime_error("Could not open <" + file_name + ">\n");
+  }
+
+  std::string text(static_cast<size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(text.data(), text.size());
+  return make_source(std::move(text));
+}
+
+#ifdef MEOW_HAS_MMAP
+class mapped_source :public source_buffer {
+public:
+  mapped_source(void* _addr, size_t _len) : addr(_addr), len(_len) {}
+  mapped_source(const mapped_source&) = delete;
+  mapped_source& operator=(const mapped_source&) = delete;
+
+  ~mapped_source() override {
+    if(addr) munmap(addr, len);
+  }
+
+  std::string_view view() const override {
+    return {static_cast<const char*>(addr), len};
+  }
+
+private:
+  void* addr; // nullptr for empty files, mmap rejects length 0
+  size_t len;
+};
+#endif
+
+// lex straight over the page cache -- falls back to read_source off posix
+inline source_ptr map_source(const std::string& file_name){
+#ifdef MEOW_HAS_MMAP
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if(fd < 0){
+    throw std::runtime_error("Could not open <" + file_name + ">\n");
+  }
+
+  struct stat info;
+  if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)){
+    close(fd);
+    return read_source(file_name); // pipes, /proc etc can't be mapped
+  }
+
+  size_t len = static_cast<size_t>(info.st_size);
+  if(len > static_cast<size_t>(INT_MAX)){
+    close(fd);
+    throw std::runtime_error("<" + file_name + "> too large to map, use stream loading\n");
+  }
+
+  void* addr = nullptr;
+  if(len > 0){
+    addr = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr == MAP_FAILED){
+      close(fd);
+      throw std::runtime_error("Could not map <" + file_name + ">\n");
+    }
+    madvise(addr, len, MADV_SEQUENTIAL);
+  }
+
+  close(fd); // mapping holds its own reference
+  return std::make_shared<const mapped_source>(addr, len);
+#else
+  return read_source(file_name);
+#endif
+}
+
+/*
+ * reads a file CHUNK bytes at a time for the STREAM load mode
+ * two buffers alternate: the partial lexeme at the end of one is carried
+ * to the front of the other. one token can take several refills to scan
+ * (whitespace and comments across chunk ends), so a view into an older
+ * buffer survives only while that buffer is pinned -- a pinned buffer is
+ * never written again, refill switches to a fresh one and the pin frees
+ * the old one. token_stream pins the buffer of each token in its lookahead
+ * */
+class chunk_reader {
+public:
+  static constexpr size_t CHUNK = 1 << 20;
+
+  using pin = std::shared_ptr<std::string>; // only ever read through
+
+  explicit chunk_reader(const std::string& file_name, size_t _chunk = CHUNK) :
+    file(file_name, std::ios::binary), chunk(_chunk) {
+    if(!file.is_open()){
+      throw std::runtime_error("Could not open <" + file_name + ">\n");
+    }
+  }
+
+  std::string_view view() const {
+    return *bufs[curr];
+  }
+
+  // holding this keeps the current buffer's text where it is
+  const pin& current() const {
+    return bufs[curr];
+  }
+
+  // keep [keep_from, end) of the current buffer at the front, append the next chunk
+  // every offset shifts down by keep_from -- false once the file is exhausted
+  bool refill(size_t keep_from){
+    // always shift, even at eof -- the tokenizer rebases unconditionally
+    // growing a pinned buffer could move it, so that's a shift too
+    if(keep_from != 0 || pinned(curr)){
+      if(pinned(curr ^ 1)) bufs[curr ^ 1] = std::make_shared<std::string>();
+      bufs[curr ^ 1]->assign(*bufs[curr], keep_from, std::string::npos);
+      curr ^= 1;
+    }
+    // otherwise nothing before the lexeme in this buffer, grow in place
+
+    if(done) return false;
+
+    std::string& buf = *bufs[curr];
+    size_t old = buf.size();
+    buf.resize(old + chunk);
+    file.read(buf.data() + old, chunk);
+    buf.resize(old + static_cast<size_t>(file.gcount()));
+
+    done = buf.size() == old;
+    return !done;
+  }
+
+private:
+  std::ifstream file;
+  size_t chunk;
+  pin bufs[2] = {std::make_shared<std::string>(), std::make_shared<std::string>()};
+  int curr = 0;
+  bool done = false;
+
+  // someone besides us holds it
+  bool pinned(int i) const {
+    return bufs[i].use_count() > 1;
+  }
+};
+
+}
+
+#endif
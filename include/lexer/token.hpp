@@ -3,14 +3,16 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <variant>
-#include <unordered_map>
+
+#include "lexer/source.hpp"
+#include "symtable/interner.hpp"
 
 namespace lexer {
 struct token; // forward dec
 
-using token_value = std::string;
+using token_value = std::string_view; // lexeme inside the source buffer
 using token_list = std::vector<token>;
 
 
@@ -76,28 +78,6 @@ enum token_type{
   UNKOWN      // Unkown
 };
 
-static const std::unordered_map<std::string, token_type> keywords = {
-  // Keywords
-  {"new", VAR},
-  {"del", DEL},
-  {"mut", MUT}
-  // {"is", ASSIGN},
-  // {"check", IF},
-  // {"or", OR},
-  // {"and", AND},
-  // {"nah", NOT},
-  // {"not", NOT},
-  // {"otherwise", ELSE},
-  // {"loop", WHILE},
-  // {"fun", FUN},
-  // {"meow", MEOW},
-  // {"result", RETURN},
-  // {"nap", BREAK},
-  // {"pursue", CONTINUE},
-  // {"fetch", IMPORT},
-};
-
-
 inline std::string token_type_to_string(token_type type) {
   switch(type) {
     // Literals
@@ -148,22 +128,66 @@ inline std::string token_type_to_string(token_type type) {
   }
 }
 
+// source text of payload-less tokens
+inline std::string_view token_spelling(token_type type) {
+  switch(type) {
+    case PLUS:       return "+";
+    case MINUS:      return "-";
+    case MULT:       return "*";
+    case DIV:        return "/";
+    case MOD:        return "%";
+    case POW:        return "^";
+    case LBRACE:     return "{";
+    case RBRACE:     return "}";
+    case LPAREN:     return "(";
+    case RPAREN:     return ")";
+    case COMMA:      return ",";
+    case DOT:        return ".";
+    case LEND:       return ";";
+    case GREATER:    return ">";
+    case LESS:       return "<";
+    case GREATER_EQ: return ">=";
+    case LESS_EQ:    return "<=";
+    case ASSIGN:     return "=";
+    case NOT_EQ:     return "!=";
+    case EQ_EQ:      return "==";
+    case NOT:        return "!";
+    default:         return "";
+  }
+}
+
+// 32 bytes -- punctuation leaves value empty, see token_spelling
 struct token {
   token_type type; 
-  token_value value;
-
   int line = 0; // for error msging
   // int column -- TODO / WONTFIX
+  token_value value;
+  union {
+    symtable::symbol_id symbol; // IDENTIFIER -- interned at lex time
+    double number = 0.0;        // NUMBER -- decoded at lex time, NaN if malformed
+  };
+
+  token() : type(UNKOWN) {} // empty lookahead slot
+
+  token(token_type _type, int _line) : 
+    type(_type), line(_line) {}
+
   token(token_type _type, token_value _value) : 
     type(_type), value(_value){}
 
-
   token(token_type _type, token_value _value, int _line) : 
-    type(_type), value(_value), line(_line) {}
+    type(_type), line(_line), value(_value) {}
+
+  // lexeme or spelling, for error msging
+  std::string text() const {
+    return std::string(value.empty() ? token_spelling(type) : value);
+  }
 };
 
 struct tokenizer {
-  std::string source; // open file
+  source_ptr buffer;       // keeps the viewed text alive
+  std::shared_ptr<chunk_reader> reader; // STREAM loading only
+  std::string_view source; // open file -- current chunk when streaming
   int pos = 0;        // pos in string
   int start = 0;      // start pos 
   int line = 1;       // curr line num -- itr with \n ?
@@ -171,12 +195,25 @@ struct tokenizer {
 
   token_list tokens;
 
-  tokenizer(std::string src, int _max) :source(src), max(_max) {};  // want max to init 
-  tokenizer(int _max) : max(_max) {};  // want max to init 
-
+  explicit tokenizer(source_ptr src) :
+    buffer(std::move(src)), source(buffer->view()), max(static_cast<int>(source.size())) {};
+
+  explicit tokenizer(std::shared_ptr<chunk_reader> src) :
+    reader(std::move(src)), max(0) {};
+
+  // pull the next chunk, carrying the lexeme in progress -- rebases pos/start
+  bool refill(){
+    if(!reader) return false;
+    bool more = reader->refill(start);
+    source = reader->view();
+    pos -= start;
+    start = 0;
+    max = static_cast<int>(source.size());
+    return more;
+  }
   // check if within bounds
   bool is_end(){
-    return (pos >= max);
+    return pos >= max && !(refill() && pos < max);
   }
 
   // show next char -- null if invalid
@@ -186,7 +223,7 @@ struct tokenizer {
   }
 
   char peak_next(){
-    if (pos + 1 >= max) return '\0';
+    if (pos + 1 >= max && !(refill() && pos + 1 < max)) return '\0';
     return source[pos+1];
   }
 
@@ -197,11 +234,19 @@ struct tokenizer {
   }
 
   void add_tok(token_type type){
-    tokens.push_back(token(type, ""));
+    tokens.emplace_back(type, line);
+  }
+
+  void add_tok(token_type type, token_value value){
+    tokens.emplace_back(type, value, line);
+  }
+
+  void add_identifier(token_value value, symtable::symbol_id symbol){
+    tokens.emplace_back(IDENTIFIER, value, line).symbol = symbol;
   }
 
-  void add_tok(token tok){
-    tokens.push_back(tok);
+  void add_number(token_value value, double number){
+    tokens.emplace_back(NUMBER, value, line).number = number;
   }
 
   void dump_tokens(){
@@ -0,0 +1,79 @@
+#ifndef TOKEN_STREAM_HPP
+#define TOKEN_STREAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+
+#include "lexer/token.hpp"
+#include "lexer/tokenizer.hpp"
+
+namespace lexer {
+
+/*
+ * cursor over a tokenizer -- tokens are scanned on demand
+ * only LOOKAHEAD tokens are ever resident so memory stays
+ * flat no matter how large the source is
+ * STREAM tokens view into the reader's chunks: each slot pins its token's
+ * chunk until the slot is filled again, so a token's text stays valid while
+ * it's in the lookahead and after next() until the following fill
+ * */
+class token_stream {
+public:
+  static constexpr std::size_t LOOKAHEAD = 2;
+
+  explicit token_stream(tokenizer src) : tok_obj(std::move(src)) {}
+
+  // already lexed tokens [first, last), then end forever -- see parser/parallel.hpp
+  // with a failure, reading past last rethrows it instead: the lex error that
+  // stopped the scan there, raised when a serial parse would have hit it
+  token_stream(const token* first, const token* last, token end, std::exception_ptr failure = nullptr) :
+    tok_obj(std::shared_ptr<chunk_reader>()), cursor(first), last(last), end(std::move(end)),
+    failure(std::move(failure)) {}
+
+  // nth token ahead of the cursor (0 = current)
+  const token& peek(std::size_t n = 0){
+    if(n >= LOOKAHEAD){
+      throw std::out_of_range("token_stream: lookahead past " + std::to_string(LOOKAHEAD));
+    }
+
+    while(count <= n) fill();
+    return ring[(head + n) % LOOKAHEAD];
+  }
+
+  // consume current token -- moved out, never copied
+  token next(){
+    peek();
+    token tok = std::move(ring[head]);
+    head = (head + 1) % LOOKAHEAD;
+    count--;
+    return tok;
+  }
+
+private:
+  tokenizer tok_obj;
+  std::array<token, LOOKAHEAD> ring;
+  std::array<chunk_reader::pin, LOOKAHEAD> pins; // STREAM only, see chunk_reader
+  std::size_t head = 0;  // slot of current token
+  std::size_t count = 0; // scanned but not consumed
+  const token* cursor = nullptr; // set: tokens come from a list, tok_obj is unused
+  const token* last = nullptr;
+  token end;
+  std::exception_ptr failure;
+
+  void fill(){
+    const std::size_t at = (head + count) % LOOKAHEAD;
+    if(cursor && cursor == last && failure) std::rethrow_exception(failure);
+    if(cursor) ring[at] = cursor < last ? *cursor++ : end;
+    else {
+      ring[at] = next_token(tok_obj); // the slot's old pin covers refills in here
+      if(tok_obj.reader && pins[at] != tok_obj.reader->current()) pins[at] = tok_obj.reader->current();
+    }
+    count++;
+  }
+};
+
+}
+
+#endif
@@ -1,14 +1,16 @@
 #ifndef TOKENIZER_HPP
 #define TOKENIZER_HPP
 
+#include <charconv>
 #include <iostream>
+#include <limits>
 #include <vector>
-#include <fstream>
-#include <sstream>
-#include <cctype>
 #include <stdlib.h>
 
 #include "lexer/token.hpp"
+#include "lexer/char_class.hpp"
+#include "lexer/keywords.hpp"
+#include "lexer/simd.hpp"
 #include "utils/string_ops.hpp"
 
 namespace lexer {
@@ -19,26 +21,21 @@ namespace lexer {
   void scan_comment(tokenizer& tok_obj);
 
   inline tokenizer new_tokenizer_runtime(std::string dump){
-    tokenizer _create_tokenizer(dump, dump.length());
+    tokenizer _create_tokenizer(make_source(std::move(dump)));
     return _create_tokenizer;
   } 
 
-  inline tokenizer new_tokenizer(std::string file_name){
-    // check file
-    std::ifstream file(file_name); 
-    if(!file.is_open()){
-      throw std::runtime_error("Could not open <" + file_name + ">\n");
-      exit(1);
+  // STREAM tokenizers only support the pull interface (next_token / parser),
+  // batch token_lists would outlive the chunk their views point into
+  inline tokenizer new_tokenizer(std::string file_name, load_mode mode = load_mode::READ){
+    switch(mode){
+    case load_mode::MMAP:
+      return tokenizer(map_source(file_name));
+    case load_mode::STREAM:
+      return tokenizer(std::make_shared<chunk_reader>(file_name));
+    default:
+      return tokenizer(read_source(file_name));
     }
-
-    // read contents into buff
-    std::stringstream buff;
-    buff << file.rdbuf();
-
-    std::string dump = buff.str();
-    // make the tokenizer obj
-    tokenizer _create_tokenizer(dump, dump.length());
-    return _create_tokenizer; 
   }
 
   inline char advance(tokenizer& tok_obj){
@@ -57,53 +54,48 @@ namespace lexer {
     return true; 
   }
 
+  // dispatch on the leading char's class -- see lexer/char_class.hpp
   inline void scan_token(tokenizer& tok_obj){
     char c = advance(tok_obj);
-    int& line_num = tok_obj.line;
-    switch(c){
-    case '(': tok_obj.add_tok({LPAREN, "(", line_num}); break;
-    case ')': tok_obj.add_tok({RPAREN, ")", line_num}); break;
-    case '{': tok_obj.add_tok({LBRACE, "{", line_num}); break;
-    case '}': tok_obj.add_tok({RBRACE, "}", line_num}); break;
-    case ',': tok_obj.add_tok({COMMA, ",", line_num}); break;
-    case '*': tok_obj.add_tok({MULT, "*", line_num}); break;
-    case '/': tok_obj.add_tok({DIV, "/", line_num}); break;
-    case '+': tok_obj.add_tok({PLUS, "+", line_num}); break;
-    case '-': tok_obj.add_tok({MINUS, "-", line_num}); break;
-    case '.': tok_obj.add_tok({DOT, ".", line_num}); break;
-    case '%': tok_obj.add_tok({MOD, "%", line_num}); break;
-    case '^': tok_obj.add_tok({POW, "^", line_num}); break;
-    case ';': tok_obj.add_tok({LEND, ";", line_num}); break;
-    case '$': scan_comment(tok_obj); break;
-    case '!': tok_obj.add_tok({match(tok_obj, '=')? NOT_EQ : NOT, "", line_num}); break;
-    case '=': tok_obj.add_tok({match(tok_obj, '=')? EQ_EQ : ASSIGN, "", line_num}); break;
-    case '<': tok_obj.add_tok({match(tok_obj, '=')? LESS_EQ : LESS, "", line_num}); break;
-    case '>': tok_obj.add_tok({match(tok_obj, '=')? GREATER_EQ : GREATER, "", line_num}); break;
-    case '\n':tok_obj.line++; break;
-    case '\b':break; // ignore 
-    case '\r':break; // ignore
-    case '\t':break; // ignore  --- Enable onelining
-    case ' ' :break; // ignore 
-    case '"' :scan_string(tok_obj); break; // string case -- check until next "
+    const char_info& info = classify(c);
+    switch(info.cls){
+    case CC_SINGLE:  tok_obj.add_tok(info.single); break;
+    case CC_EQ_PAIR: tok_obj.add_tok(match(tok_obj, '=')? info.paired : info.single); break;
+    case CC_NEWLINE: tok_obj.line++; break;
+    case CC_SPACE:   break; // ignore  --- Enable onelining
+    case CC_COMMENT: scan_comment(tok_obj); break;
+    case CC_QUOTE:   scan_string(tok_obj); break; // string case -- check until next "
+    case CC_DIGIT:   scan_number(tok_obj); break;
+    case CC_ALPHA:   scan_identifier(tok_obj); break;
     default:
-      if(isdigit(c)){
-        scan_number(tok_obj);
-      } else if(isalpha(c)) {
-        scan_identifier(tok_obj);
-      } else {
-        throw std::runtime_error("Unexpected character on line " + std::to_string(tok_obj.line) + ": " + std::string(1, c) + "\n");
-      }
-  }  
+      throw std::runtime_error("Unexpected character on line " + std::to_string(tok_obj.line) + ": " + std::string(1, c) + "\n");
+    }
+  }
+
+  // move pos to the end of a run found by a simd kernel (see lexer/simd.hpp)
+  // kernels stop at max, so keep going while a STREAM refill adds more
+  template<typename Kernel>
+  inline void advance_run(tokenizer& tok_obj, Kernel kernel){
+    do {
+      const char* base = tok_obj.source.data();
+      tok_obj.pos = static_cast<int>(kernel(base + tok_obj.pos, base + tok_obj.max) - base);
+    } while(tok_obj.pos >= tok_obj.max && !tok_obj.is_end());
+  }
+
+  // whitespace runs are skipped here instead of one scan_token call per char
+  inline void skip_whitespace(tokenizer& tok_obj){
+    tok_obj.start = tok_obj.pos;
+    advance_run(tok_obj, [&](const char* p, const char* end){
+      return simd::active().skip_space(p, end, tok_obj.line);
+    });
   }
 
   inline void scan_comment(tokenizer& tok_obj){
 
-    while(tok_obj.peak() != '\n' &&  tok_obj.peak() != '$'){
-      if(tok_obj.is_end()){
-        return; 
-      }
-      advance(tok_obj); 
-    } 
+    advance_run(tok_obj, simd::active().find_comment_end);
+    if(tok_obj.is_end()){
+      return; 
+    }
 
     // needed if using inline commenting
     if(tok_obj.peak_next() == '\n'){
@@ -117,59 +109,54 @@ namespace lexer {
     advance(tok_obj); 
   }
 
-  inline bool is_iden_allowed_char(char c){
-    return (std::isalnum(c) || c == '_');
-  }
-
-
   inline void scan_identifier(tokenizer& tok_obj){
-    while(is_iden_allowed_char(tok_obj.peak())) {
-      advance(tok_obj);
-    }
+    advance_run(tok_obj, simd::active().iden_end);
 
     int& start = tok_obj.start;
     int& end = tok_obj.pos;
-    std::string& src = tok_obj.source;
 
     // grab the found keyword
-    std::string extracted_keyword = utils::sub_str(src, start, end);
+    std::string_view extracted_keyword = utils::sub_str(tok_obj.source, start, end);
 
-    // check if valid keyword
-    auto tok_type = keywords.find(extracted_keyword);
-    if(tok_type != keywords.end()){
-      tok_obj.add_tok({tok_type->second, extracted_keyword, tok_obj.line});
+    // keyword or IDENTIFIER -- perfect hash, see lexer/keywords.hpp
+    token_type type = keyword_type(extracted_keyword);
+    if(type == IDENTIFIER){
+      tok_obj.add_identifier(extracted_keyword, symtable::intern(extracted_keyword));
     }
-
-    // if not found in map then call IDENTIFIER
-    else tok_obj.add_tok({IDENTIFIER, extracted_keyword, tok_obj.line});
+    else tok_obj.add_tok(type, extracted_keyword);
   }
 
   inline void scan_number(tokenizer& tok_obj){
     int& start= tok_obj.start;
 
     // scan entire whole value
-    while(!tok_obj.is_end() && isdigit(tok_obj.peak())) advance(tok_obj);
+    advance_run(tok_obj, simd::active().digit_end);
     // handle decimal numbers
-    if(tok_obj.peak() == '.' && isdigit(tok_obj.peak_next())) {
+    if(tok_obj.peak() == '.' && simd::is_digit(tok_obj.peak_next())) {
       advance(tok_obj);
 
       // handle fractional portion
-      while(!tok_obj.is_end() && isdigit(tok_obj.peak())) advance(tok_obj);
+      advance_run(tok_obj, simd::active().digit_end);
     }
 
-    std::string& src = tok_obj.source; 
     int end= tok_obj.pos;
-    int& line= tok_obj.line;
-    std::string value = utils::sub_str(src, start, end);
-    tok_obj.add_tok(token(NUMBER, value, line));
+    std::string_view text = utils::sub_str(tok_obj.source, start, end);
+
+    // decode once here -- the parser reports NaN as malformed with the line
+    double value = 0.0;
+    auto [last, err] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if(err != std::errc() || last != text.data() + text.size()){
+      value = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    tok_obj.add_number(text, value);
 }
 
 inline void scan_string(tokenizer& tok_obj){
   int& start = tok_obj.start;
-  while(tok_obj.peak() != '"'){
-    if(tok_obj.peak() == '\n') tok_obj.line++; // may needrefactor
-    advance(tok_obj);
-  }
+  advance_run(tok_obj, [&](const char* p, const char* end){
+    return simd::active().find_quote(p, end, tok_obj.line);
+  });
 
   if(tok_obj.is_end()){
     throw std::runtime_error("Unterminated string on line " + std::to_string(tok_obj.line) + "\n");
@@ -178,26 +165,47 @@ inline void scan_string(tokenizer& tok_obj){
 
   advance(tok_obj); // consume closing quote
   int end = tok_obj.pos;
-  std::string str_val = utils::sub_str(tok_obj.source, start, end);
-  tok_obj.add_tok({STRING, str_val, tok_obj.line});
+  tok_obj.add_tok(STRING, utils::sub_str(tok_obj.source, start, end));
 }
 
   
-  inline void scan_tokens(tokenizer& tok_obj){
-    while(!tok_obj.is_end()){
+  // everything from pos to max, no END_OF_FILE -- parallel chunks stitch these
+  inline void scan_remaining(tokenizer& tok_obj){
+    while(true){
+      skip_whitespace(tok_obj);
+      if(tok_obj.is_end()) break;
       tok_obj.start = tok_obj.pos;
       scan_token(tok_obj);
     }
+  }
+
+  inline void scan_tokens(tokenizer& tok_obj){
+    scan_remaining(tok_obj);
+    tok_obj.add_tok(END_OF_FILE);
+  }
+
+  // scan until exactly one token is produced -- pull interface for the parser
+  inline token next_token(tokenizer& tok_obj){
+    while(tok_obj.tokens.empty()){
+      skip_whitespace(tok_obj);
+      tok_obj.start = tok_obj.pos; // before is_end so a refill carries nothing
+      if(tok_obj.is_end()){
+        return token(END_OF_FILE, tok_obj.line);
+      }
+      scan_token(tok_obj); // emits at most one token
+    }
 
-    int& curr_line = tok_obj.line;
-    tok_obj.add_tok({END_OF_FILE, "", curr_line});
+    token tok = std::move(tok_obj.tokens.front());
+    tok_obj.tokens.clear(); // keeps capacity, no realloc next time
+    return tok;
   }
 
-  inline std::vector<token> tokenize_file(std::string file_name){
+  // whole file at once -- tokens view into the returned tokenizer's buffer
+  inline tokenizer tokenize_file(std::string file_name){
     auto tok_obj = new_tokenizer(file_name); 
     scan_tokens(tok_obj);
     // tok_obj.dump_tokens();
-    return tok_obj.tokens;
+    return tok_obj;
   }     
 
 }
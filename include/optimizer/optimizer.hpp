@@ -0,0 +1,169 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include <climits>
+#include <cstddef>
+#include <unordered_set>
+
+#include "interpreter/operators.hpp"
+#include "parser/node_types.hpp"
+
+namespace optimizer {
+
+struct stats {
+  size_t nodes_before = 0;
+  size_t nodes_after = 0;
+
+  size_t removed() const {
+    return nodes_before - nodes_after;
+  }
+};
+
+inline size_t count_nodes(const parser::statement* node){
+  if(!node) return 0;
+
+  switch(node->kind){
+    case parser::PROGRAM: {
+      size_t n = 1;
+      for(auto* stmt : static_cast<const parser::program*>(node)->body){
+        n += count_nodes(stmt);
+      }
+      return n;
+    }
+
+    case parser::VAR_DEC:
+      return 1 + count_nodes(static_cast<const parser::var_dec*>(node)->type);
+
+    case parser::BINARY_EXP: {
+      auto* bin = static_cast<const parser::binary_exp*>(node);
+      return 1 + count_nodes(bin->left) + count_nodes(bin->right);
+    }
+
+    default:
+      return 1;
+  }
+}
+
+/*
+ * rewrites a program in place between make_ast and eval_program
+ *  - number OP number folds to a literal, same math as the interpreter
+ *  - nil OP x and x OP nil become x for arithmetic OPs (the coalesce handler)
+ *  - x*1, 1*x, x/1, x-0 become x when x is known to be a number
+ * division by zero is never folded -- the node stays so the runtime error
+ * fires on its original line. x+0 is left alone too, -0 + 0 is +0
+ * replacement nodes come from the program's arena, the old ones just go dead
+ * */
+class folder {
+public:
+  explicit folder(utils::arena& _nodes) : nodes(_nodes) {}
+
+  parser::statement* fold_stmt(parser::statement* node){
+    if(node->kind != parser::VAR_DEC){
+      return fold_exp(static_cast<parser::expression*>(node));
+    }
+
+    auto* decl = static_cast<parser::var_dec*>(node);
+    if(decl->type) decl->type = fold_exp(decl->type);
+
+    // straight line code -- a later redeclaration simply overwrites this
+    if(!decl->mut && decl->type && is_numeric(decl->type)){
+      numeric.insert(decl->identifier);
+    } else {
+      numeric.erase(decl->identifier);
+    }
+    return decl;
+  }
+
+  parser::expression* fold_exp(parser::expression* node){
+    if(node->kind != parser::BINARY_EXP) return node;
+
+    auto* bin = static_cast<parser::binary_exp*>(node);
+    bin->left = fold_exp(bin->left);
+    bin->right = fold_exp(bin->right);
+
+    auto* lhs = bin->left;
+    auto* rhs = bin->right;
+
+    // comparisons and and/or make bools, no literal node for those yet
+    if(!parser::is_arithmetic(bin->op)) return bin;
+
+    if(lhs->kind == parser::NULL_LITERAL) return rhs;
+    if(rhs->kind == parser::NULL_LITERAL) return lhs;
+
+    if(lhs->kind == parser::NUMERIC_LITERAL && rhs->kind == parser::NUMERIC_LITERAL){
+      double l = value_of(lhs);
+      double r = value_of(rhs);
+      if(!foldable(bin->op, l, r)) return bin;
+
+      auto* lit = nodes.make<parser::numeric_literal>(
+        interpreter::num_binary_op(l, r, bin->op, bin->line));
+      lit->line = bin->line;
+      return lit;
+    }
+
+    const auto op = bin->op;
+    if(is_constant(rhs, 1.0) && (op == parser::OP_MUL || op == parser::OP_DIV) && is_numeric(lhs)) return lhs;
+    if(is_constant(lhs, 1.0) && op == parser::OP_MUL && is_numeric(rhs)) return rhs;
+    if(is_constant(rhs, 0.0) && op == parser::OP_SUB && is_numeric(lhs)) return lhs;
+
+    return bin;
+  }
+
+private:
+  utils::arena& nodes;
+  std::unordered_set<symtable::symbol_id> numeric; // `new` bindings holding a number
+
+  static double value_of(const parser::expression* node){
+    return static_cast<const parser::numeric_literal*>(node)->value;
+  }
+
+  static bool is_constant(const parser::expression* node, double value){
+    return node->kind == parser::NUMERIC_LITERAL && value_of(node) == value;
+  }
+
+  static bool fits_int(double v){
+    return v > static_cast<double>(INT_MIN) - 1.0 && v < static_cast<double>(INT_MAX) + 1.0;
+  }
+
+  // leave anything that errors (or is UB in the int cast) to the runtime
+  static bool foldable(parser::binary_op op, double l, double r){
+    if(op == parser::OP_MOD && !(fits_int(l) && fits_int(r))) return false;
+    return !interpreter::divides_by_zero(op, r);
+  }
+
+  // evaluates to a number whenever it evaluates at all
+  bool is_numeric(const parser::expression* node) const {
+    switch(node->kind){
+      case parser::NUMERIC_LITERAL:
+        return true;
+
+      case parser::IDENTIFIER:
+        return numeric.count(static_cast<const parser::identifier*>(node)->symbol) != 0;
+
+      case parser::BINARY_EXP: {
+        auto* bin = static_cast<const parser::binary_exp*>(node);
+        return parser::is_arithmetic(bin->op) && is_numeric(bin->left) && is_numeric(bin->right);
+      }
+
+      default:
+        return false;
+    }
+  }
+};
+
+inline stats optimize(parser::program& prgrm){
+  stats result;
+  result.nodes_before = count_nodes(&prgrm);
+
+  folder pass(prgrm.nodes);
+  for(auto& stmt : prgrm.body){
+    stmt = pass.fold_stmt(stmt);
+  }
+
+  result.nodes_after = count_nodes(&prgrm);
+  return result;
+}
+
+}
+
+#endif
@@ -1,9 +1,15 @@
 #ifndef NODE_TYPE_HPP
 #define NODE_TYPE_HPP
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
-#include <memory>
+
+#include "symtable/interner.hpp"
+#include "utils/arena.hpp"
+
+namespace interpreter { struct value; }
+namespace jit { struct fragment; }
 
 namespace parser {
 
@@ -25,20 +31,71 @@ enum node_type {
   FUN_DEC,
 };
 
-// could refactor to make abstract... not worth?
+// resolved from the operator token once, at parse time
+enum binary_op : uint8_t {
+  // arithmetic
+  OP_ADD,
+  OP_SUB,
+  OP_MUL,
+  OP_DIV,
+  OP_MOD,
+
+  // comparison -- produce bools
+  OP_EQ,
+  OP_NOT_EQ,
+  OP_LESS,
+  OP_LESS_EQ,
+  OP_GREATER,
+  OP_GREATER_EQ,
+
+  // logical -- short circuit, yield an operand like lua
+  OP_AND,
+  OP_OR,
+
+  OP_COUNT
+};
+
+inline bool is_arithmetic(binary_op op){
+  return op <= OP_MOD;
+}
+
+inline std::string_view op_spelling(binary_op op){
+  constexpr std::string_view text[OP_COUNT] = {
+    "+", "-", "*", "/", "%", "==", "!=", "<", "<=", ">", ">=", "and", "or",
+  };
+  return op < OP_COUNT ? text[op] : "?";
+}
+
+/*
+ * nodes are bump allocated from their program's arena (see utils/arena.hpp)
+ * so they must stay trivially destructible: children are plain pointers
+ * and text is a string_view into the arena
+ * */
 struct statement {
   node_type kind;
+  int line = 0; // for error msging, set by the parser
   statement(node_type k) : kind(k) {}
-  virtual ~statement() = default;
 };
 
 
+// (scope depth, slot) filled in by the resolver -- depth -1 means look the
+// name up dynamically (REPL globals declared later, del, ...)
+struct address {
+  int depth = -1;
+  uint32_t slot = 0;
+
+  bool resolved() const {
+    return depth >= 0;
+  }
+};
+
 struct program :public statement {
-  std::vector<std::unique_ptr<statement>> body;
+  utils::arena nodes;            // owns every node below, freed in one go
+  std::vector<statement*> body;
 
   program() : statement(node_type::PROGRAM) {}
-  void add(std::unique_ptr<statement> stmt){
-    body.push_back(std::move(stmt)); 
+  void add(statement* stmt){
+    body.push_back(stmt); 
   }
 };
 
@@ -49,56 +106,74 @@ struct expression :public statement {
 
 struct var_dec :public statement {
   bool mut;
-  std::string identifier;
-  std::unique_ptr<expression> type;
+  symtable::symbol_id identifier;
+  expression* type;
+  address addr;     // depth is always 0, declarations land in the current scope
 
 
-  var_dec(): statement(node_type::VAR_DEC), mut(true), type(nullptr){} // NODE Type
+  var_dec(): statement(node_type::VAR_DEC), mut(true), identifier(0), type(nullptr){} // NODE Type
 
   // idk how to make this formatted in a less ugly way sorry lmao
   var_dec
   (
     bool _mut,
-    std::string id,
-    std::unique_ptr<expression> typ
+    symtable::symbol_id id,
+    expression* typ
   ):
     statement(node_type::VAR_DEC), // NODE Type
     mut(_mut),                     // mutable 
     identifier(id),                // Identifier name
-    type(std::move(typ)){}                    // expr type
+    type(typ){}                    // expr type
 };
 
-struct binary_exp :public expression {
-    std::unique_ptr<expression> left;
-    std::unique_ptr<expression> right;
-    std::string op;
+// operand type pairs one operator site has seen, and the handler
+// specialized for each -- filled in by the tree walker, see interpreter/feedback.hpp
+struct site_cache {
+  using handler = interpreter::value (*)(interpreter::value& lhs, interpreter::value& rhs, int line);
+  static constexpr int ways = 2; // past this many pairs the site goes megamorphic
+
+  uint8_t size = 0;
+  bool megamorphic = false;
+  uint8_t keys[ways] = {};       // lhs type * 4 + rhs type
+  uint32_t hits = 0;             // for --stats, the site's line is hot anyway
+  uint32_t misses = 0;
+  handler targets[ways] = {};
+};
 
-    binary_exp(std::unique_ptr<expression> l,
-               std::unique_ptr<expression> r,
-               std::string o)
+struct binary_exp :public expression {
+    expression* left;
+    expression* right;
+    binary_op op;
+    site_cache cache;
+    const jit::fragment* native = nullptr; // compiled subtree, see jit/x64.hpp
+
+    binary_exp(expression* l,
+               expression* r,
+               binary_op o)
         : expression(node_type::BINARY_EXP),
-          left(std::move(l)), right(std::move(r)), op(std::move(o)) {}
+          left(l), right(r), op(o) {}
 };
 
 struct identifier :public expression {
-  std::string symbol; // x, foo, etc
-  identifier(): expression(node_type::IDENTIFIER) {};
-  identifier(std::string sym):
+  symtable::symbol_id symbol; // x, foo, etc -- symtable::symbol_name for text
+  address addr;
+  identifier(): expression(node_type::IDENTIFIER), symbol(0) {};
+  identifier(symtable::symbol_id sym):
     expression(node_type::IDENTIFIER), symbol(sym) {};
 };
 
-// refactor for float / double / unsigned etc
+// decoded by the lexer -- evaluating is a load
 struct numeric_literal :public expression {
-  std::string symbol; // x, foo, etc
-  numeric_literal(): expression(node_type::NUMERIC_LITERAL) {};
-  numeric_literal(std::string sym):
-    expression(node_type::NUMERIC_LITERAL), symbol(sym) {};
+  double value;
+  numeric_literal(): expression(node_type::NUMERIC_LITERAL), value(0.0) {};
+  numeric_literal(double val):
+    expression(node_type::NUMERIC_LITERAL), value(val) {};
 };
 
 struct nil_literal :public expression {
-  std::string symbol; // x, foo, etc
+  std::string_view symbol; // x, foo, etc
   nil_literal(): expression(node_type::NULL_LITERAL) {};
-  nil_literal(std::string sym):
+  nil_literal(std::string_view sym):
     expression(node_type::NULL_LITERAL), symbol(sym) {};
 };
 
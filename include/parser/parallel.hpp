@@ -0,0 +1,90 @@
+#ifndef PARALLEL_PARSER_HPP
+#define PARALLEL_PARSER_HPP
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#include "lexer/parallel.hpp"
+#include "parser/parser.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace parser {
+
+// fewer tokens than this per task and the split costs more than it saves
+inline constexpr size_t MIN_TASK_TOKENS = 1 << 12;
+
+/*
+ * make_ast on a pool -- same body, same lines, same error
+ * the source is lexed in parallel, then the token list is cut just past
+ * top level `;`s. only a var_dec consumes a `;` and it ends right there, so
+ * a cut is always a statement start: each slice parses on its own, into its
+ * own program/arena, with an END_OF_FILE carrying the next token's line in
+ * place of the rest of the file. slices are joined in order (arena::absorb
+ * keeps the node pointers), and if any failed the first one in source order
+ * is rethrown -- everything before it parsed fine, so it's the error
+ * make_ast would have stopped at
+ * a lex error doesn't win outright: the tokens stop just before it and the
+ * last slice rethrows it only once parsing reaches that point, so an earlier
+ * parse error (even in the same statement) is still the one reported
+ * STREAM tokenizers can't be lexed ahead and parse serially, and so does a one
+ * thread pool -- the pull parser never holds the whole token list
+ * */
+inline program parse_parallel(lexer::tokenizer src, utils::thread_pool& pool){
+  if(src.reader || pool.size() < 2){
+    parse parsed(std::move(src));
+    return parsed.make_ast();
+  }
+
+  std::exception_ptr lex_failure = lexer::scan_tokens_until_error(src, pool);
+  if(lex_failure) src.add_tok(lexer::END_OF_FILE); // stand in, never parsed past
+  const lexer::token_list& toks = src.tokens;
+  const size_t count = toks.size() - 1; // without END_OF_FILE
+
+  // a few slices per thread so uneven statements even out
+  const size_t slices = std::min(pool.size() * 4, count / MIN_TASK_TOKENS);
+  std::vector<size_t> cuts{0};
+  for(size_t i = 1; i < slices; i++){
+    size_t at = std::max(count / slices * i, cuts.back());
+    while(at < count && toks[at].type != lexer::LEND) at++;
+    if(at + 1 >= count) break;
+    cuts.push_back(at + 1);
+  }
+  cuts.push_back(count);
+
+  struct slice {
+    program prgrm;
+    std::exception_ptr failure;
+  };
+  std::vector<slice> parts(cuts.size() - 1);
+
+  pool.for_each(parts.size(), [&](size_t i){
+    const lexer::token* first = toks.data() + cuts[i];
+    const lexer::token* last = toks.data() + cuts[i + 1];
+    const bool tail = i + 1 == parts.size();
+    try {
+      parse parsed(first, last, lexer::token(lexer::END_OF_FILE, last->line), tail ? lex_failure : nullptr);
+      parts[i].prgrm = parsed.make_ast();
+    } catch(...) {
+      parts[i].failure = std::current_exception();
+    }
+  });
+
+  program prgrm;
+  size_t statements = 0;
+  for(auto& part : parts){
+    if(part.failure) std::rethrow_exception(part.failure);
+    statements += part.prgrm.body.size();
+  }
+
+  prgrm.body.reserve(statements);
+  for(auto& part : parts){
+    prgrm.nodes.absorb(std::move(part.prgrm.nodes));
+    prgrm.body.insert(prgrm.body.end(), part.prgrm.body.begin(), part.prgrm.body.end());
+  }
+  return prgrm;
+}
+
+}
+
+#endif
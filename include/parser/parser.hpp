@@ -1,9 +1,12 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
-#include <memory>
+#include <algorithm>
+#include <exception>
+#include <initializer_list>
 #include <string>
 #include "lexer/token.hpp"
+#include "lexer/token_stream.hpp"
 #include "parser/node_types.hpp"
 #include "utils/dump.hpp"
 
@@ -12,11 +15,17 @@ class parse {
 
 
 public:
-  parse(lexer::token_list toks) : tokens(toks){}
+  parse(lexer::tokenizer src) : tokens(std::move(src)){}
+
+  // a slice of a lexed token_list, end stands in for whatever follows it
+  // -- or failure is thrown there, see lexer::token_stream
+  parse(const lexer::token* first, const lexer::token* last, lexer::token end, std::exception_ptr failure = nullptr) :
+    tokens(first, last, std::move(end), std::move(failure)){}
 
   // generate abstract syntax tree
   program make_ast(){
     program prgrm;
+    nodes = &prgrm.nodes;
 
     while(!eof()){
       prgrm.body.push_back(parse_stmt());
@@ -25,30 +34,37 @@ public:
     return prgrm;
   }
 
-  lexer::token curr_tok(){
-    return tokens[0];
+  const lexer::token& curr_tok(){
+    return tokens.peek();
   }
 
+  // owned copy -- the token's view dies with the lookahead slot
   std::string advance(){
-    const auto prev_val = curr_tok().value;
-    tokens.erase(tokens.begin());
-    return prev_val;
+    return tokens.next().text();
   }
 
   lexer::token_type advance_type(){
-    const auto prev_val = curr_tok().type;
-    tokens.erase(tokens.begin());
-    return prev_val;
+    return tokens.next().type;
   }
 
 private:
-  lexer::token_list tokens;
+  lexer::token_stream tokens;
+  utils::arena* nodes = nullptr; // arena of the program being built
 
   bool eof() {
-    return tokens[0].type == lexer::END_OF_FILE;
+    return curr_tok().type == lexer::END_OF_FILE;
+  }
+
+  // arena allocate a node stamped with its source line
+  template<typename T, typename... Args>
+  T* make_node(int line, Args&&... args){
+    T* node = nodes->make<T>(std::forward<Args>(args)...);
+    node->line = line;
+    return node;
   }
 
-std::unique_ptr<statement> parse_var_dec(){
+statement* parse_var_dec(){
+  const int line = curr_tok().line;
   bool is_mut = advance_type() == lexer::token_type::MUT; // check mut first
 
   // ensure that assigning if mut
@@ -56,7 +72,7 @@ std::unique_ptr<statement> parse_var_dec(){
     advance(); // eat VAR 
   }
 
-  const auto iden = expect(lexer::token_type::IDENTIFIER, "Expected Identifier Following `mut`/`var`");
+  const auto iden = expect(lexer::token_type::IDENTIFIER, "Expected Identifier Following `mut`/`var`").symbol;
   
   // check if semicolon (uninitialized declaration)
   if(curr_tok().type == lexer::token_type::LEND){
@@ -68,21 +84,22 @@ std::unique_ptr<statement> parse_var_dec(){
       exit(1);
     }
 
-    return std::make_unique<var_dec>(is_mut, iden.value, nullptr);
+    return make_node<var_dec>(line, is_mut, iden, nullptr);
   } 
 
   // Otherwise expect assignment
   expect(lexer::token_type::ASSIGN, "Expected assignment following identifier in variable decleration");
-  auto decl = std::make_unique<var_dec>(
+  auto decl = make_node<var_dec>(
+    line,
     is_mut,
-    iden.value,
+    iden,
     parse_exp()
   );
   
   expect(lexer::token_type::LEND, "Expected `;` following variable decleration");
   return decl;
 }
-  std::unique_ptr<statement> parse_stmt(){
+  statement* parse_stmt(){
     switch(curr_tok().type) {
     case lexer::VAR:
       return parse_var_dec();
@@ -95,47 +112,48 @@ std::unique_ptr<statement> parse_var_dec(){
     }
   }
 
-  std::unique_ptr<expression> parse_exp(){
-    return parse_additive_exp(); 
+  expression* parse_exp(){
+    return parse_or_exp(); 
   }
 
-
-  std::unique_ptr<expression> parse_mult_exp(){
-    auto left = parse_prim_exp(); 
-
-    while (
-         curr_tok().type == lexer::MULT 
-      || curr_tok().type == lexer::DIV 
-      || curr_tok().type == lexer::MOD
-    ){
-      auto oper = advance();
-      auto right = parse_prim_exp();
-      left = std::make_unique<binary_exp>(
-        std::move(left), 
-        std::move(right), 
-        oper
-      );
+  static binary_op to_binary_op(lexer::token_type type){
+    switch(type){
+      case lexer::PLUS:       return OP_ADD;
+      case lexer::MINUS:      return OP_SUB;
+      case lexer::MULT:       return OP_MUL;
+      case lexer::DIV:        return OP_DIV;
+      case lexer::MOD:        return OP_MOD;
+      case lexer::EQ_EQ:      return OP_EQ;
+      case lexer::NOT_EQ:     return OP_NOT_EQ;
+      case lexer::LESS:       return OP_LESS;
+      case lexer::LESS_EQ:    return OP_LESS_EQ;
+      case lexer::GREATER:    return OP_GREATER;
+      case lexer::GREATER_EQ: return OP_GREATER_EQ;
+      case lexer::AND:        return OP_AND;
+      case lexer::OR:         return OP_OR;
+      default:
+        throw std::runtime_error("PARSER: Not a binary operator: " + lexer::token_type_to_string(type) + "\n");
     }
-
-    return left;
   }
 
   /*
-   * for 5+5 for example
+   * one left associative precedence level, 5+5 for example
    * first get left: 5
    * then advance to operator
-   * then get the next operator
+   * then get the next operand from the level above
    * assign to left for recursive
    * */
-  std::unique_ptr<expression> parse_additive_exp(){
-    auto left = parse_mult_exp(); 
-
-    while (curr_tok().type == lexer::PLUS || curr_tok().type == lexer::MINUS){
-      auto oper = advance();
-      auto right = parse_mult_exp();
-      left = std::make_unique<binary_exp>(
-        std::move(left), 
-        std::move(right), 
+  expression* parse_binary_level(expression* (parse::*operand)(), std::initializer_list<lexer::token_type> ops){
+    auto left = (this->*operand)(); 
+
+    while(std::find(ops.begin(), ops.end(), curr_tok().type) != ops.end()){
+      const int line = curr_tok().line;
+      auto oper = to_binary_op(advance_type());
+      auto right = (this->*operand)();
+      left = make_node<binary_exp>(
+        line,
+        left, 
+        right, 
         oper
       );
     }
@@ -143,30 +161,58 @@ std::unique_ptr<statement> parse_var_dec(){
     return left;
   }
 
-  lexer::token expect(lexer::token_type type, std::string err){
-    const auto prev = curr_tok();
+  // lowest to highest: or, and, equality, comparison, additive, multiplicative
+  expression* parse_or_exp(){
+    return parse_binary_level(&parse::parse_and_exp, {lexer::OR});
+  }
+
+  expression* parse_and_exp(){
+    return parse_binary_level(&parse::parse_equality_exp, {lexer::AND});
+  }
+
+  expression* parse_equality_exp(){
+    return parse_binary_level(&parse::parse_comparison_exp, {lexer::EQ_EQ, lexer::NOT_EQ});
+  }
+
+  expression* parse_comparison_exp(){
+    return parse_binary_level(&parse::parse_additive_exp,
+      {lexer::LESS, lexer::LESS_EQ, lexer::GREATER, lexer::GREATER_EQ});
+  }
+
+  expression* parse_additive_exp(){
+    return parse_binary_level(&parse::parse_mult_exp, {lexer::PLUS, lexer::MINUS});
+  }
+
+  expression* parse_mult_exp(){
+    return parse_binary_level(&parse::parse_prim_exp, {lexer::MULT, lexer::DIV, lexer::MOD});
+  }
+
+  lexer::token expect(lexer::token_type type, const char* err){
+    const auto& prev = curr_tok();
 
     if(prev.type != type){
-      throw std::runtime_error("PARSER: " + err + "\n" +
+      throw std::runtime_error(std::string("PARSER: ") + err + "\n" +
       "\tExpecting: "+ lexer::token_type_to_string(type) + "\n" + 
       "\tRecieved: " + lexer::token_type_to_string(prev.type) + "\n");
       exit(1);
     }
 
-    tokens.erase(tokens.begin());
-    return prev;
+    return tokens.next();
   }
 
   // identify type
-  std::unique_ptr<expression> parse_prim_exp(){
-    const auto tok = curr_tok();
+  expression* parse_prim_exp(){
+    const auto& tok = curr_tok();
     switch(tok.type){
 
       case lexer::IDENTIFIER:
-        return std::make_unique<identifier>(advance());
+        return make_node<identifier>(tok.line, tokens.next().symbol);
 
       case lexer::NUMBER:
-        return std::make_unique<numeric_literal>(advance());
+        if(tok.number != tok.number){ // NaN, see lexer::scan_number
+          throw std::runtime_error("\nPARSER: Malformed number [" + tok.text() + "] on line " + std::to_string(tok.line) + "\n");
+        }
+        return make_node<numeric_literal>(tok.line, tokens.next().number);
 
       case lexer::LPAREN: {
         advance();
@@ -188,15 +234,16 @@ std::unique_ptr<statement> parse_var_dec(){
 
       // null value
       case lexer::NIL: {
+        const int line = tok.line;
         advance(); // advance past null
-        return std::make_unique<nil_literal>("nil"); // add 
+        return make_node<nil_literal>(line, "nil"); // add 
       }
       
       case lexer::LEND: {
       }
 
       default: 
-        throw std::runtime_error("\nPARSER: Unexpected token [" + tok.value + "] on line " + std::to_string(tok.line) + "\n");
+        throw std::runtime_error("\nPARSER: Unexpected token [" + tok.text() + "] on line " + std::to_string(tok.line) + "\n");
         exit(1);
     } 
   }
@@ -0,0 +1,97 @@
+#ifndef RESOLVER_HPP
+#define RESOLVER_HPP
+
+#include <unordered_map>
+
+#include "parser/node_types.hpp"
+#include "symtable/environment.hpp"
+
+namespace resolver {
+
+/*
+ * static pass after parsing (and optimizing): gives every var_dec and
+ * identifier a (depth, slot) address into the environment chain eval will
+ * run in, so the interpreter indexes straight into the slot vector
+ *
+ * slots are predicted, not reserved -- env is only read here. new names get
+ * env's next free slots in declaration order, exactly what declare_at fills
+ * at runtime. so resolve against the same env you evaluate in, with nothing
+ * declared in between
+ *
+ * a name only resolves once its declaration has been seen, so `x; new x = 1;`
+ * still reports x undefined. anything not found stays unresolved and takes
+ * the dynamic lookup
+ * */
+class resolver {
+public:
+  explicit resolver(symtable::environment* _env) :
+    env(_env), next_slot(_env->slot_count()) {}
+
+  void resolve_stmt(parser::statement* node){
+    switch(node->kind){
+      case parser::VAR_DEC: {
+        auto* decl = static_cast<parser::var_dec*>(node);
+        if(decl->type) resolve_stmt(decl->type); // `new x = x + 1` sees the old x
+
+        auto slot = local_slot(decl->identifier);
+        if(slot < 0){
+          slot = next_slot++;
+          declared.emplace(decl->identifier, static_cast<uint32_t>(slot));
+        }
+        decl->addr = {0, static_cast<uint32_t>(slot)};
+        break;
+      }
+
+      case parser::IDENTIFIER: {
+        auto* ident = static_cast<parser::identifier*>(node);
+        ident->addr = lookup(ident->symbol);
+        break;
+      }
+
+      case parser::BINARY_EXP: {
+        auto* bin = static_cast<parser::binary_exp*>(node);
+        resolve_stmt(bin->left);
+        resolve_stmt(bin->right);
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+private:
+  symtable::environment* env;                            // scope the program runs in
+  std::unordered_map<symtable::symbol_id, uint32_t> declared; // names this program adds to env
+  uint32_t next_slot;
+
+  // slot in the program's own scope: declared earlier here, or already in env
+  int64_t local_slot(symtable::symbol_id name) const {
+    auto it = declared.find(name);
+    if(it != declared.end()) return it->second;
+    return env->slot_of(name);
+  }
+
+  parser::address lookup(symtable::symbol_id name) const {
+    auto slot = local_slot(name);
+    if(slot >= 0) return {0, static_cast<uint32_t>(slot)};
+
+    int depth = 1;
+    for(auto* scope = env->enclosing(); scope; scope = scope->enclosing(), depth++){
+      slot = scope->slot_of(name);
+      if(slot >= 0) return {depth, static_cast<uint32_t>(slot)};
+    }
+    return {}; // dynamic
+  }
+};
+
+inline void resolve(parser::program& prgrm, symtable::environment* env){
+  resolver pass(env);
+  for(auto* stmt : prgrm.body){
+    pass.resolve_stmt(stmt);
+  }
+}
+
+}
+
+#endif
@@ -3,77 +3,169 @@
 
 #include <iostream>
 #include "interpreter/values.hpp"
+#include "symtable/interner.hpp"
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace symtable {
 
-using var_table = std::unordered_map<std::string, std::unique_ptr<interpreter::runtime_val>>;
+// values live in slots, declaration order -- the resolver hands out the
+// same indices ahead of time so resolved names skip the hashing entirely
+using slot_list = std::vector<interpreter::value>;
 
+// keyed on interned ids -- integer hashing, never a string compare
+using slot_index = std::unordered_map<symbol_id, uint32_t>;
+
+// block frames come and go constantly -- their slot vectors are recycled
+// so a warm push/pop never touches the allocator
+inline std::vector<slot_list>& spare_slots() {
+  thread_local std::vector<slot_list> spares;
+  return spares;
+}
+
+/*
+ * one activation frame: a slot vector and a parent link
+ * named frames (globals, the REPL) also keep a name -> slot table for the
+ * dynamic path and for the resolver to read. block frames are sized by the
+ * resolver and addressed by slot only; the dynamic path skips them unless
+ * something declares into one by name, which builds the table on demand
+ * */
 class environment {
 public:
-  explicit environment(environment* p = nullptr) : parent(p) {}
-  
-  ~environment() = default;  // unique_ptr handles cleanup automatically
+  // named frame
+  explicit environment(environment* p = nullptr) :
+    parent(p), index(std::make_unique<slot_index>()) {}
+
+  // block frame with room for slot_count locals
+  environment(environment* p, uint32_t slot_count) : parent(p) {
+    auto& spares = spare_slots();
+    if (!spares.empty()) {
+      slots = std::move(spares.back());
+      spares.pop_back();
+    }
+    slots.resize(slot_count);
+  }
+
+  environment(const environment&) = delete;
+  environment& operator=(const environment&) = delete;
+
+  // fresh named frame with the same names and values, same parent -- how
+  // each batch script gets its own globals from one template. only reads
+  // the template, so any number of threads can clone it at once as long as
+  // nobody runs code in it meanwhile (string payloads are shared by refcount)
+  std::unique_ptr<environment> clone() const {
+    auto copy = std::make_unique<environment>(parent);
+    if (index) *copy->index = *index;
+    copy->slots = slots;
+    return copy;
+  }
+
+  ~environment() {
+    if (!index) {
+      slots.clear(); // values die here, the capacity goes back for reuse
+      spare_slots().push_back(std::move(slots));
+    }
+  }
 
-  interpreter::runtime_val* declare_variable(const std::string& name, interpreter::runtime_val* val) {
+  interpreter::value* declare_variable(symbol_id name, interpreter::value val) {
     // redeclaring in scope just change value
-    variables[name] = std::unique_ptr<interpreter::runtime_val>(val);
-    return variables[name].get();
+    auto [it, fresh] = names().try_emplace(name, static_cast<uint32_t>(slots.size()));
+    if (fresh) {
+      slots.emplace_back();
+    }
+    slots[it->second] = std::move(val);
+    return &slots[it->second];
   }
 
-  interpreter::runtime_val* declare_variable(const std::string& name, interpreter::rtpoint val) {
-    variables[name] = std::move(val);
-    return variables[name].get();
+  // declare into the slot the resolver picked for this name
+  interpreter::value* declare_at(uint32_t slot, symbol_id name, interpreter::value val) {
+    // slots fill in declaration order, so only a new slot needs indexing
+    if (slot >= slots.size()) {
+      slots.resize(slot + 1);
+      if (index) (*index)[name] = slot;
+    }
+    slots[slot] = std::move(val);
+    return &slots[slot];
   }
 
   // assign variable -- error warning on redeclare 
-  interpreter::runtime_val* assign_variable(const std::string& name, interpreter::runtime_val* val) {
-    const auto env = resolve(name);
-    if (!env) {
-      throw std::runtime_error("Cannot assign to undefined variable: " + name);
+  interpreter::value* assign_variable(symbol_id name, interpreter::value val) {
+    auto* cell = find(name);
+    if (!cell) {
+      throw std::runtime_error("Cannot assign to undefined variable: " + symbol_name(name));
     }
-    env->variables[name] = std::unique_ptr<interpreter::runtime_val>(val);
-    return env->variables[name].get();
+    *cell = std::move(val);
+    return cell;
   }
 
-  interpreter::runtime_val* assign_variable(const std::string& name, interpreter::rtpoint val) {
-    const auto env = resolve(name);
-    if (!env) {
-      throw std::runtime_error("Cannot assign to undefined variable: " + name);
-    }
-    env->variables[name] = std::move(val);
-    return env->variables[name].get();
+  // dynamic path: hash the name in each named frame up the chain - nullptr if not found
+  interpreter::value* lookup_variable(symbol_id name) {
+    return find(name);
   }
 
-  // resolve env then return if exists - nullptr if not
-  interpreter::runtime_val* lookup_variable(const std::string& name) {
-    const auto env = resolve(name);
-    if (!env) {
-      return nullptr;
+  // resolved path: depth frames up, straight to the slot
+  interpreter::value* lookup_at(int depth, uint32_t slot) {
+    environment* env = this;
+    while (depth-- > 0) {
+      env = env->parent;
     }
-    return env->variables[name].get();
+    return slot < env->slots.size() ? &env->slots[slot] : nullptr;
   }
 
   // variable scope resolution
-  environment* resolve(const std::string& name) {
-    // if variable found in curr scope
-    if (variables.find(name) != variables.end()) {
-      return this;
-    }
-    // check parent scope
-    else {
-      if (parent == nullptr) {
-        return nullptr;
+  environment* resolve(symbol_id name) {
+    for (environment* env = this; env; env = env->parent) {
+      if (env->index && env->index->count(name)) {
+        return env;
       }
-      return parent->resolve(name);
     }
+    return nullptr;
+  }
+
+  // slot of a name declared in this frame only, -1 if none (or unnamed)
+  int64_t slot_of(symbol_id name) const {
+    if (!index) return -1;
+    auto it = index->find(name);
+    return it == index->end() ? -1 : static_cast<int64_t>(it->second);
+  }
+
+  const interpreter::value* slot_data() const {
+    return slots.data();
+  }
+
+  uint32_t slot_count() const {
+    return static_cast<uint32_t>(slots.size());
+  }
+
+  environment* enclosing() const {
+    return parent;
   }
 
 private:
   environment* parent;
-  var_table variables;
+  slot_list slots;
+  std::unique_ptr<slot_index> index; // null for block frames
+
+  slot_index& names() {
+    if (!index) {
+      index = std::make_unique<slot_index>();
+    }
+    return *index;
+  }
+
+  // one hash per named frame, the value's cell comes back with the hit
+  interpreter::value* find(symbol_id name) {
+    for (environment* env = this; env; env = env->parent) {
+      if (!env->index) continue;
+      auto it = env->index->find(name);
+      if (it != env->index->end()) {
+        return &env->slots[it->second];
+      }
+    }
+    return nullptr;
+  }
 };
 
 }
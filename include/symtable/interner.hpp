@@ -0,0 +1,147 @@
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace symtable {
+
+// compact id for a name -- equal names always get the same id
+using symbol_id = uint32_t;
+
+/*
+ * maps every distinct name to a symbol_id once, at lex time, so the
+ * AST and environments compare / hash plain integers
+ * thread safe: lookups share a lock, only new names take it exclusively
+ * names are never dropped, so a table grows with every distinct name it
+ * sees -- runs that shouldn't keep theirs use a run_symbols scope below
+ * */
+class interner {
+public:
+  // ids handed out by a table layered over a base, see run_symbols
+  static constexpr symbol_id LOCAL_IDS = symbol_id(1) << 31;
+
+  interner() = default;
+
+  // names base already had by now keep base's ids, anything newer is ours
+  // -- fixed at construction so the answer can't change mid run
+  explicit interner(const interner* base_table) : base(base_table), base_size(base_table->size()) {}
+
+  interner(const interner&) = delete;
+  interner& operator=(const interner&) = delete;
+
+  symbol_id intern(std::string_view name){
+    {
+      std::shared_lock lock(mutex);
+      auto found = ids.find(name);
+      if(found != ids.end()) return found->second;
+    }
+
+    symbol_id id;
+    if(base && base->lookup(name, id) && id < base_size) return id;
+
+    std::unique_lock lock(mutex);
+    auto found = ids.find(name); // raced with another writer
+    if(found != ids.end()) return found->second;
+
+    const std::string& stored = names.emplace_back(name); // deque: never moves
+    id = first_id() + static_cast<symbol_id>(names.size() - 1);
+    ids.emplace(stored, id);
+    return id;
+  }
+
+  // no insert, false if the name is new
+  bool lookup(std::string_view name, symbol_id& id) const {
+    std::shared_lock lock(mutex);
+    auto found = ids.find(name);
+    if(found == ids.end()) return false;
+    id = found->second;
+    return true;
+  }
+
+  std::string_view name(symbol_id id) const {
+    if(base && id < LOCAL_IDS) return base->name(id);
+    std::shared_lock lock(mutex);
+    return names.at(id - first_id());
+  }
+
+  size_t size() const {
+    std::shared_lock lock(mutex);
+    return names.size();
+  }
+
+  // process wide table, everything not inside a run_symbols scope uses it
+  static interner& global(){
+    static interner table;
+    return table;
+  }
+
+private:
+  const interner* base = nullptr;
+  size_t base_size = 0;
+  mutable std::shared_mutex mutex;
+  std::deque<std::string> names;                          // id -> name
+  std::unordered_map<std::string_view, symbol_id> ids;    // views into names
+
+  symbol_id first_id() const { return base ? LOCAL_IDS : 0; }
+};
+
+// the table intern() / symbol_name() use on this thread, null: the global one
+inline interner*& active_table(){
+  thread_local interner* table = nullptr;
+  return table;
+}
+
+inline interner& current_interner(){
+  interner* table = active_table();
+  return table ? *table : interner::global();
+}
+
+// table is this thread's current one until the scope ends -- worker threads
+// lexing for a run use it to intern into the run's table
+class interner_scope {
+public:
+  explicit interner_scope(interner& table) : previous(std::exchange(active_table(), &table)) {}
+  ~interner_scope(){ active_table() = previous; }
+
+  interner_scope(const interner_scope&) = delete;
+  interner_scope& operator=(const interner_scope&) = delete;
+
+private:
+  interner* previous;
+};
+
+/*
+ * one run's names, freed with the scope -- --batch wraps each script in one
+ * so a long lived process doesn't keep every name it ever lexed. names the
+ * global table already had (true, false, ...) keep their global ids, so
+ * environments built before the run still match
+ * */
+class run_symbols {
+public:
+  run_symbols() = default;
+  run_symbols(const run_symbols&) = delete;
+  run_symbols& operator=(const run_symbols&) = delete;
+
+private:
+  interner table{&interner::global()};
+  interner_scope use{table};
+};
+
+inline symbol_id intern(std::string_view name){
+  return current_interner().intern(name);
+}
+
+inline std::string symbol_name(symbol_id id){
+  return std::string(current_interner().name(id));
+}
+
+}
+
+#endif
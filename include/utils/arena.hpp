@@ -0,0 +1,100 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/*
+ * bump allocator -- objects are laid out back to back in allocation order
+ * and released all at once when the arena dies, nothing is destructed
+ * individually so only trivially destructible types may live here
+ * */
+class arena {
+public:
+  static constexpr size_t FIRST_BLOCK = 1 << 10;
+  static constexpr size_t MAX_BLOCK = 1 << 16;
+
+  arena() = default;
+  arena(arena&&) = default;
+  arena& operator=(arena&&) = default;
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  void* allocate(size_t size, size_t align){
+    size_t offset = (used + align - 1) & ~(align - 1);
+    if(blocks.empty() || offset + size > capacity){
+      grow(size + align);
+      offset = (used + align - 1) & ~(align - 1);
+    }
+
+    used = offset + size;
+    total += size;
+    return blocks.back().get() + offset;
+  }
+
+  template<typename T, typename... Args>
+  T* make(Args&&... args){
+    static_assert(std::is_trivially_destructible_v<T>, "arena never runs destructors");
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // copy text into the arena, view lives as long as the arena
+  std::string_view copy(std::string_view text){
+    if(text.empty()) return {};
+    char* dst = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(dst, text.data(), text.size());
+    return {dst, text.size()};
+  }
+
+  // take over another arena's blocks -- its pointers stay valid
+  void absorb(arena&& other){
+    if(other.blocks.empty()) return;
+    if(blocks.empty()){
+      *this = std::move(other);
+      return;
+    }
+
+    // keep our current block last so allocation continues in it
+    auto current = std::move(blocks.back());
+    blocks.pop_back();
+    for(auto& block : other.blocks) blocks.push_back(std::move(block));
+    blocks.push_back(std::move(current));
+
+    total += other.total;
+    reserved += other.reserved;
+    other = arena();
+  }
+
+  size_t bytes_used() const { return total; }
+  size_t bytes_reserved() const { return reserved; }
+
+private:
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  size_t capacity = 0; // of blocks.back()
+  size_t used = 0;     // bytes taken in blocks.back()
+  size_t total = 0;
+  size_t reserved = 0;
+
+  void grow(size_t min_size){
+    size_t size = blocks.empty() ? FIRST_BLOCK : capacity * 2;
+    if(size > MAX_BLOCK) size = MAX_BLOCK;
+    if(size < min_size) size = min_size;
+
+    blocks.emplace_back(new std::byte[size]); // uninitialised, unlike make_unique
+    capacity = size;
+    used = 0;
+    reserved += size;
+  }
+};
+
+}
+
+#endif
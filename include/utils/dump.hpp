@@ -2,6 +2,7 @@
 #define DUMP_HPP
 
 #include "parser/node_types.hpp"
+#include "utils/number_format.hpp"
 #include <iostream>
 #include <string>
 namespace utils {
@@ -18,7 +19,7 @@ inline void dump_ast(const statement* node, int indent = 0) {
             auto* prog = static_cast<const program*>(node);
             std::cout << spacing << "Program {\n";
             for (const auto& stmt : prog->body) {
-                dump_ast(stmt.get(), indent + 1);
+                dump_ast(stmt, indent + 1);
             }
             std::cout << spacing << "}\n";
             break;
@@ -26,23 +27,29 @@ inline void dump_ast(const statement* node, int indent = 0) {
         
         case NUMERIC_LITERAL: {
             auto* lit = static_cast<const numeric_literal*>(node);
-            std::cout << spacing << "NumericLiteral: " << lit->symbol << "\n";
+            number_buffer buf;
+            std::cout << spacing << "NumericLiteral: " << format_number(lit->value, buf) << "\n";
             break;
         }
         
+        case NULL_LITERAL: {
+            std::cout << spacing << "NilLiteral\n";
+            break;
+        }
+
         case IDENTIFIER: {
             auto* id = static_cast<const identifier*>(node);
-            std::cout << spacing << "Identifier: " << id->symbol << "\n";
+            std::cout << spacing << "Identifier: " << symtable::symbol_name(id->symbol) << "\n";
             break;
         }
         
         case BINARY_EXP: {
             auto* bin = static_cast<const binary_exp*>(node);
-            std::cout << spacing << "BinaryExpression: " << bin->op << " {\n";
+            std::cout << spacing << "BinaryExpression: " << op_spelling(bin->op) << " {\n";
             std::cout << spacing << "  left:\n";
-            dump_ast(bin->left.get(), indent + 2);
+            dump_ast(bin->left, indent + 2);
             std::cout << spacing << "  right:\n";
-            dump_ast(bin->right.get(), indent + 2);
+            dump_ast(bin->right, indent + 2);
             std::cout << spacing << "}\n";
             break;
         }
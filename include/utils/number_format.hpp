@@ -0,0 +1,32 @@
+#ifndef NUMBER_FORMAT_HPP
+#define NUMBER_FORMAT_HPP
+
+#include <charconv>
+#include <string>
+#include <string_view>
+
+namespace utils {
+
+// longest shortest-roundtrip double: "-2.2250738585072014e-308" is 24
+inline constexpr size_t NUMBER_CHARS = 32;
+
+using number_buffer = char[NUMBER_CHARS];
+
+/*
+ * the one place numbers become text: shortest digits that parse back to
+ * the same double (1, 0.1, 1e+21, -0, inf, nan), no locale, no allocation.
+ * the view points into buf, reuse buf for the next number
+ * */
+inline std::string_view format_number(double num, number_buffer& buf) {
+  auto res = std::to_chars(buf, buf + NUMBER_CHARS, num);
+  return std::string_view(buf, res.ptr - buf);
+}
+
+inline void append_number(std::string& out, double num) {
+  number_buffer buf;
+  out += format_number(num, buf);
+}
+
+}
+
+#endif
@@ -1,14 +1,12 @@
 #ifndef STRING_OPS_HPP
 #define STRING_OPS_HPP
 #include <iostream>
+#include <string_view>
 
 namespace utils {
-inline std::string sub_str(std::string& src, size_t start, size_t end){
-  std::string buff; 
-  for(; start < end; start++){
-    buff += src[start];
-  }
-  return buff;
+// view of [start, end) -- no copy, lives as long as src
+inline std::string_view sub_str(std::string_view src, size_t start, size_t end){
+  return src.substr(start, end - start);
 }
 }
 
@@ -0,0 +1,112 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+/*
+ * fixed set of workers for fork/join jobs -- for_each(n, fn) runs fn(0..n-1)
+ * spread over the workers and the calling thread, which counts as one of
+ * them. tasks are handed out one index at a time so uneven tasks balance
+ * themselves. one job at a time, the workers sleep in between
+ * */
+class thread_pool {
+public:
+  explicit thread_pool(size_t threads = std::thread::hardware_concurrency()){
+    for(size_t i = 1; i < threads; i++) workers.emplace_back([this]{ work(); });
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool(){
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for(auto& worker : workers) worker.join();
+  }
+
+  size_t size() const { return workers.size() + 1; }
+
+  // blocks until every task ran, then rethrows the first exception a task threw
+  template<typename Fn>
+  void for_each(size_t count, Fn&& fn){
+    std::lock_guard one_job(submit);
+    {
+      std::lock_guard lock(mutex);
+      job = [&fn](size_t i){ fn(i); };
+      job_size = count;
+      next = 0;
+      busy = workers.size();
+      failure = nullptr;
+      generation++;
+    }
+    wake.notify_all();
+    drain();
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this]{ return busy == 0; });
+    job = nullptr;
+    if(failure) std::rethrow_exception(std::exchange(failure, nullptr));
+  }
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex submit; // serializes for_each callers
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  std::function<void(size_t)> job;
+  size_t job_size = 0;
+  std::atomic<size_t> next{0};
+  size_t busy = 0;       // workers still inside the current job
+  uint64_t generation = 0;
+  bool stopping = false;
+  std::exception_ptr failure;
+
+  void work(){
+    uint64_t seen = 0;
+    while(true){
+      {
+        std::unique_lock lock(mutex);
+        wake.wait(lock, [&]{ return stopping || generation != seen; });
+        if(stopping) return;
+        seen = generation;
+      }
+      drain();
+      {
+        std::lock_guard lock(mutex);
+        busy--;
+      }
+      done.notify_one();
+    }
+  }
+
+  void drain(){
+    for(size_t i = next++; i < job_size; i = next++){
+      try {
+        job(i);
+      } catch(...) {
+        std::lock_guard lock(mutex);
+        if(!failure) failure = std::current_exception();
+      }
+    }
+  }
+};
+
+}
+
+#endif
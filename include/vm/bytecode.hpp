@@ -0,0 +1,141 @@
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "interpreter/values.hpp"
+
+namespace vm {
+
+/*
+ * one list so the opcode enum, the vm's computed goto table and the
+ * disassembler names can't drift apart. operands follow the opcode byte:
+ * u8 is one byte, u32 four bytes little endian. jumps only go forward,
+ * their u32 offset counts from the end of the instruction
+ * the binary ops run in parser::binary_op order, see compiler.hpp
+ * */
+#define MEOW_OPCODES(X)                                              \
+  X(LOAD_CONST)    /* u32 constant                 -> value   */    \
+  X(LOAD_NIL)      /*                              -> nil     */    \
+  X(LOAD_SLOT)     /* u8 depth, u32 slot, u32 sym  -> value   */    \
+  X(LOAD_NAME)     /* u32 sym, dynamic lookup      -> value   */    \
+  X(DECLARE_SLOT)  /* u32 slot, u32 sym     value  -> value   */    \
+  X(DECLARE_NAME)  /* u32 sym               value  -> value   */    \
+  X(POP)           /*                       value  ->         */    \
+  X(ADD)                                                            \
+  X(SUB)                                                            \
+  X(MUL)                                                            \
+  X(DIV)                                                            \
+  X(MOD)                                                            \
+  X(EQ)                                                             \
+  X(NOT_EQ)                                                         \
+  X(LESS)                                                           \
+  X(LESS_EQ)                                                        \
+  X(GREATER)                                                        \
+  X(GREATER_EQ)                                                     \
+  X(JUMP_IF_FALSE) /* u32, keeps the value when jumping, else pops */ \
+  X(JUMP_IF_TRUE)  /* u32, same                                   */ \
+  X(RETURN)        /*                       value  -> result  */
+
+enum opcode : uint8_t {
+#define MEOW_OPCODE_ENUM(name) name,
+  MEOW_OPCODES(MEOW_OPCODE_ENUM)
+#undef MEOW_OPCODE_ENUM
+  OPCODE_COUNT
+};
+
+inline const char* opcode_name(uint8_t op) {
+  static const char* names[OPCODE_COUNT] = {
+#define MEOW_OPCODE_NAME(name) #name,
+    MEOW_OPCODES(MEOW_OPCODE_NAME)
+#undef MEOW_OPCODE_NAME
+  };
+  return op < OPCODE_COUNT ? names[op] : "?";
+}
+
+// code from `start` on was compiled from `line`, until the next run
+struct line_run {
+  uint32_t start;
+  int line;
+};
+
+// compiled program -- code plus what the vm needs to run it
+struct chunk {
+  std::vector<uint8_t> code;
+  std::vector<line_run> lines;               // only grows when the line changes, errors only
+  std::vector<interpreter::value> constants;
+  uint32_t max_stack = 0;                    // deepest the value stack gets
+
+  void emit(uint8_t op, int line) {
+    if (lines.empty() || lines.back().line != line) {
+      lines.push_back({static_cast<uint32_t>(code.size()), line});
+    }
+    code.push_back(op);
+  }
+
+  // operands share their opcode's line
+  void emit_u8(uint8_t byte) {
+    code.push_back(byte);
+  }
+
+  void emit_u32(uint32_t word) {
+    uint8_t bytes[4];
+    std::memcpy(bytes, &word, sizeof(word)); // every target we build for is little endian
+    code.insert(code.end(), bytes, bytes + 4);
+  }
+
+  void patch_u32(size_t at, uint32_t word) {
+    std::memcpy(&code[at], &word, sizeof(word));
+  }
+
+  int line_at(size_t offset) const {
+    auto run = std::upper_bound(lines.begin(), lines.end(), offset,
+      [](size_t at, const line_run& r) { return at < r.start; });
+    return run == lines.begin() ? 0 : std::prev(run)->line;
+  }
+};
+
+inline uint32_t read_u32(const uint8_t* at) {
+  uint32_t word;
+  std::memcpy(&word, at, sizeof(word));
+  return word;
+}
+
+// operand bytes after each opcode
+inline size_t operand_size(uint8_t op) {
+  switch (op) {
+    case LOAD_CONST:
+    case LOAD_NAME:
+    case DECLARE_NAME:
+    case JUMP_IF_FALSE:
+    case JUMP_IF_TRUE:  return 4;
+    case DECLARE_SLOT:  return 8;
+    case LOAD_SLOT:     return 9;
+    default:            return 0;
+  }
+}
+
+// offset, line, opcode and raw operands, one instruction per line
+inline void disassemble(const chunk& prog, std::ostream& out = std::cout) {
+  for (size_t at = 0; at < prog.code.size(); at += 1 + operand_size(prog.code[at])) {
+    uint8_t op = prog.code[at];
+    out << at << "\t[" << prog.line_at(at) << "]\t" << opcode_name(op);
+    if (op == LOAD_SLOT) {
+      out << " " << int(prog.code[at + 1]) << " " << read_u32(&prog.code[at + 2]);
+    } else {
+      for (size_t word = 0; word < operand_size(op); word += 4) {
+        out << " " << read_u32(&prog.code[at + 1 + word]);
+      }
+    }
+    out << "\n";
+  }
+}
+
+}
+
+#endif
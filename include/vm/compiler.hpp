@@ -0,0 +1,133 @@
+#ifndef COMPILER_HPP
+#define COMPILER_HPP
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "parser/node_types.hpp"
+#include "vm/bytecode.hpp"
+
+namespace vm {
+
+static_assert(EQ - ADD == parser::OP_EQ - parser::OP_ADD &&
+              GREATER_EQ - ADD == parser::OP_GREATER_EQ - parser::OP_ADD,
+              "binary opcodes must follow parser::binary_op order");
+
+/*
+ * parser::program -> chunk. run it after the resolver: resolved names
+ * compile to slot loads, the rest to dynamic name lookups. every statement
+ * leaves its value on the stack and all but the last pop it, so the
+ * result is the tree walker's `last_eval`
+ * */
+class compiler {
+public:
+  chunk compile(const parser::program& prgrm) {
+    const auto& body = prgrm.body;
+    for (size_t i = 0; i < body.size(); i++) {
+      compile_node(body[i]);
+      if (i + 1 < body.size()) {
+        emit(POP, body[i]->line, -1);
+      }
+    }
+    if (body.empty()) emit(LOAD_NIL, 0, 1);
+    emit(RETURN, body.empty() ? 0 : body.back()->line, -1);
+    return std::move(out);
+  }
+
+private:
+  chunk out;
+  uint32_t depth = 0; // current stack depth
+  std::unordered_map<uint64_t, uint32_t> number_consts; // bit pattern -> pool index
+
+  void emit(opcode op, int line, int stack_effect) {
+    out.emit(op, line);
+    depth += stack_effect;
+    if (depth > out.max_stack) out.max_stack = depth;
+  }
+
+  uint32_t constant(double number) {
+    uint64_t bits;
+    std::memcpy(&bits, &number, sizeof(bits)); // keeps -0 and 0 apart
+    auto [it, fresh] = number_consts.try_emplace(bits, static_cast<uint32_t>(out.constants.size()));
+    if (fresh) out.constants.push_back(interpreter::make_number(number));
+    return it->second;
+  }
+
+  void compile_node(const parser::statement* node) {
+    switch (node->kind) {
+      case parser::NUMERIC_LITERAL:
+        emit(LOAD_CONST, node->line, 1);
+        out.emit_u32(constant(static_cast<const parser::numeric_literal*>(node)->value));
+        break;
+
+      case parser::NULL_LITERAL:
+        emit(LOAD_NIL, node->line, 1);
+        break;
+
+      case parser::IDENTIFIER: {
+        auto* ident = static_cast<const parser::identifier*>(node);
+        if (ident->addr.resolved() && ident->addr.depth <= UINT8_MAX) {
+          emit(LOAD_SLOT, node->line, 1);
+          out.emit_u8(static_cast<uint8_t>(ident->addr.depth));
+          out.emit_u32(ident->addr.slot);
+        } else {
+          emit(LOAD_NAME, node->line, 1);
+        }
+        out.emit_u32(ident->symbol); // LOAD_SLOT keeps it for the dynamic fallback
+        break;
+      }
+
+      case parser::VAR_DEC: {
+        auto* decl = static_cast<const parser::var_dec*>(node);
+        if (decl->type) compile_node(decl->type);
+        else emit(LOAD_NIL, node->line, 1);
+
+        if (decl->addr.resolved()) {
+          emit(DECLARE_SLOT, node->line, 0);
+          out.emit_u32(decl->addr.slot);
+        } else {
+          emit(DECLARE_NAME, node->line, 0);
+        }
+        out.emit_u32(decl->identifier);
+        break;
+      }
+
+      case parser::BINARY_EXP:
+        compile_binary(static_cast<const parser::binary_exp*>(node));
+        break;
+
+      default:
+        throw std::runtime_error("COMPILER: AST Node kind not implemented for bytecode on line " +
+                                 std::to_string(node->line));
+    }
+  }
+
+  void compile_binary(const parser::binary_exp* bin) {
+    compile_node(bin->left);
+
+    if (bin->op == parser::OP_AND || bin->op == parser::OP_OR) {
+      // lhs stays as the result when the jump is taken, popped otherwise
+      emit(bin->op == parser::OP_AND ? JUMP_IF_FALSE : JUMP_IF_TRUE, bin->line, 0);
+      size_t patch_at = out.code.size();
+      out.emit_u32(0);
+
+      depth--; // the fall through path pops lhs before rhs runs
+      compile_node(bin->right);
+      out.patch_u32(patch_at, static_cast<uint32_t>(out.code.size() - (patch_at + 4)));
+      return;
+    }
+
+    compile_node(bin->right);
+    emit(static_cast<opcode>(ADD + (bin->op - parser::OP_ADD)), bin->line, -1);
+  }
+};
+
+inline chunk compile(const parser::program& prgrm) {
+  return compiler().compile(prgrm);
+}
+
+}
+
+#endif
@@ -0,0 +1,181 @@
+#ifndef VM_HPP
+#define VM_HPP
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "interpreter/error.hpp"
+#include "interpreter/operators.hpp"
+#include "symtable/environment.hpp"
+#include "vm/bytecode.hpp"
+#include "vm/compiler.hpp"
+
+// labels as values -- one indirect jump per opcode instead of a shared switch
+// build with -DMEOW_NO_COMPUTED_GOTO to get the portable switch loop
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(MEOW_NO_COMPUTED_GOTO)
+#define MEOW_COMPUTED_GOTO 1
+#endif
+
+namespace vm {
+
+/*
+ * runs a chunk against env (the environment the resolver saw)
+ * no per instruction try/catch, interpreter::error carries its line out of the loop
+ * */
+inline interpreter::value run(const chunk& prog, symtable::environment* env) {
+  using interpreter::value;
+
+  auto stack = std::make_unique<value[]>(prog.max_stack + 1);
+  value* sp = stack.get();
+  const uint8_t* const base = prog.code.data();
+  const uint8_t* ip = base;
+  const value* consts = prog.constants.data();
+
+  // source line of an instruction, from its opcode byte
+  auto line_at = [&](const uint8_t* op_start) { return prog.line_at(op_start - base); };
+
+  // div and mod look their line up only when they are about to throw
+  auto checked = [&](parser::binary_op op, double l, double r) {
+    int line = interpreter::divides_by_zero(op, r) ? line_at(ip - 1) : 0;
+    return interpreter::make_number(interpreter::num_binary_op(l, r, op, line));
+  };
+
+  // ip is just past the opcode byte when the loads call this
+  auto undefined = [&](uint32_t sym) {
+    return interpreter::error(interpreter::error_kind::UNDEFINED_VARIABLE,
+                              "Undefined variable: " + symtable::symbol_name(sym), line_at(ip - 1));
+  };
+
+#ifdef MEOW_COMPUTED_GOTO
+  static const void* targets[OPCODE_COUNT] = {
+#define MEOW_OPCODE_LABEL(name) &&do_##name,
+    MEOW_OPCODES(MEOW_OPCODE_LABEL)
+#undef MEOW_OPCODE_LABEL
+  };
+#define DISPATCH() goto *targets[*ip++]
+#define CASE(name) do_##name
+  DISPATCH();
+#else
+#define DISPATCH() continue
+#define CASE(name) case name
+  for (;;) switch (*ip++) {
+#endif
+
+  CASE(LOAD_CONST): {
+    *sp++ = consts[read_u32(ip)];
+    ip += 4;
+    DISPATCH();
+  }
+
+  CASE(LOAD_NIL): {
+    *sp++ = value();
+    DISPATCH();
+  }
+
+  CASE(LOAD_SLOT): {
+    auto* val = env->lookup_at(ip[0], read_u32(ip + 1));
+    if (!val) {
+      uint32_t sym = read_u32(ip + 5);
+      val = env->lookup_variable(sym);
+      if (!val) throw undefined(sym);
+    }
+    *sp++ = *val;
+    ip += 9;
+    DISPATCH();
+  }
+
+  CASE(LOAD_NAME): {
+    uint32_t sym = read_u32(ip);
+    auto* val = env->lookup_variable(sym);
+    if (!val) throw undefined(sym);
+    *sp++ = *val;
+    ip += 4;
+    DISPATCH();
+  }
+
+  CASE(DECLARE_SLOT): {
+    env->declare_at(read_u32(ip), read_u32(ip + 4), sp[-1]);
+    ip += 8;
+    DISPATCH();
+  }
+
+  CASE(DECLARE_NAME): {
+    env->declare_variable(read_u32(ip), sp[-1]);
+    ip += 4;
+    DISPATCH();
+  }
+
+  CASE(POP): {
+    *--sp = value();
+    DISPATCH();
+  }
+
+  // numbers stay in the loop, everything else goes through the type-pair table
+#define BINARY(name, expr)                                                        \
+  CASE(name): {                                                                   \
+    value& lhs = sp[-2];                                                          \
+    value& rhs = sp[-1];                                                          \
+    if (lhs.type == interpreter::NUMBER && rhs.type == interpreter::NUMBER) {     \
+      const double l = lhs.number, r = rhs.number;                                \
+      lhs = expr;                                                                 \
+    } else {                                                                      \
+      auto op = static_cast<parser::binary_op>(parser::OP_ADD + (name - ADD));    \
+      lhs = interpreter::apply_binary(op, lhs, rhs, line_at(ip - 1));             \
+      rhs = value();                                                              \
+    }                                                                             \
+    sp--;                                                                         \
+    DISPATCH();                                                                   \
+  }
+
+  BINARY(ADD, interpreter::make_number(l + r))
+  BINARY(SUB, interpreter::make_number(l - r))
+  BINARY(MUL, interpreter::make_number(l * r))
+  BINARY(DIV, checked(parser::OP_DIV, l, r))
+  BINARY(MOD, checked(parser::OP_MOD, l, r))
+  BINARY(EQ, interpreter::make_bool(l == r))
+  BINARY(NOT_EQ, interpreter::make_bool(l != r))
+  BINARY(LESS, interpreter::make_bool(l < r))
+  BINARY(LESS_EQ, interpreter::make_bool(l <= r))
+  BINARY(GREATER, interpreter::make_bool(l > r))
+  BINARY(GREATER_EQ, interpreter::make_bool(l >= r))
+#undef BINARY
+
+  CASE(JUMP_IF_FALSE): {
+    uint32_t offset = read_u32(ip);
+    ip += 4;
+    if (!interpreter::is_truthy(sp[-1])) ip += offset;
+    else *--sp = value();
+    DISPATCH();
+  }
+
+  CASE(JUMP_IF_TRUE): {
+    uint32_t offset = read_u32(ip);
+    ip += 4;
+    if (interpreter::is_truthy(sp[-1])) ip += offset;
+    else *--sp = value();
+    DISPATCH();
+  }
+
+  CASE(RETURN): {
+    return std::move(sp[-1]);
+  }
+
+#ifndef MEOW_COMPUTED_GOTO
+  default:
+    throw interpreter::error(interpreter::error_kind::UNSUPPORTED, "VM: Unknown opcode " + std::to_string(ip[-1]),
+                             line_at(ip - 1));
+  }
+#endif
+#undef DISPATCH
+#undef CASE
+}
+
+// drop in for interpreter::eval_program
+inline interpreter::value eval_program(parser::program* prgrm, symtable::environment* env) {
+  return run(compile(*prgrm), env);
+}
+
+}
+
+#endif
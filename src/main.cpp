@@ -1,44 +1,118 @@
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>  
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include <lexer/tokenizer.hpp>
 #include <parser/parser.hpp>
 #include <utils/dump.hpp>
+#include "utils/number_format.hpp"
 #include "interpreter/interpreter.hpp"
 #include "interpreter/values.hpp"
-#include "interpreter/casting.hpp"
 #include "lexer/token.hpp"
+#include "optimizer/optimizer.hpp"
+#include "resolver/resolver.hpp"
+#include "cache/meowc.hpp"
+#include "parser/parallel.hpp"
+#include "closure/closure.hpp"
+#include "jit/x64.hpp"
+#include "vm/vm.hpp"
 #include "symtable/environment.hpp"
 
 using namespace std;
 
-void print_value(interpreter::runtime_val* val) {
-  switch(val->type) {
+void print_value(const interpreter::value& val, std::ostream& out = std::cout) {
+  switch(val.type) {
     case interpreter::NUMBER: {
-      auto num = interpreter::as_ptr<interpreter::number_val>(val);
-      std::cout << num->value;
+      utils::number_buffer buf;
+      out << utils::format_number(val.number, buf);
       break;
     }
     case interpreter::NIL: {
-      std::cout << "nil";
+      out << "nil";
       break;
     }
     case interpreter::BOOL: {
-      auto boolean = interpreter::as_ptr<interpreter::bool_val>(val);
-      std::cout << (boolean->value ? "true" : "false");
+      out << (val.boolean ? "true" : "false");
+      break;
+    }
+    case interpreter::STR: {
+      out << val.str();
       break;
     }
     default:
-      std::cout << "unknown";
+      out << "unknown";
+  }
+}
+
+// command line flags -- everything else is the file to run
+enum class engine { TREE, VM, CLOSURE };
+
+struct run_options {
+  lexer::load_mode load = lexer::load_mode::READ;
+  engine exec = engine::TREE;
+  bool optimize = true;
+  bool jit = false;
+  bool stats = false;
+  bool cache = false;
+  std::string cache_dir; // empty: <script>.meowc next to the script
+  size_t parse_threads = 1;
+  bool batch = false;
+  size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+  const char* file = nullptr;
+  std::vector<std::string> batch_files; // --batch: empty means read paths from stdin
+};
+
+// parse (and fold) a tokenizer's source
+parser::program build_program(lexer::tokenizer tokens, const run_options& opts) {
+  parser::program program;
+  if(opts.parse_threads > 1) {
+    utils::thread_pool pool(opts.parse_threads);
+    program = parser::parse_parallel(std::move(tokens), pool);
+  } else {
+    parser::parse parsed(std::move(tokens));
+    program = parsed.make_ast();
   }
+  if(opts.optimize) optimizer::optimize(program);
+  return program;
 }
 
-void execute_and_print(parser::program& program, symtable::environment* env) {
-  auto ret = interpreter::eval_program(&program, env);
-  print_value(ret.get());
-  std::cout << std::endl;
+// --cache: reuse the .meowc for this exact source, rebuild it otherwise
+parser::program load_cached(const run_options& opts) {
+  auto source = opts.load == lexer::load_mode::READ ? lexer::read_source(opts.file) : lexer::map_source(opts.file);
+  auto key = cache::make_key(opts.file, source->view(), opts.optimize);
+  auto file = cache::cache_file(key, opts.file, opts.cache_dir);
+
+  parser::program cached;
+  if(cache::load(file, key, cached) == cache::load_status::LOADED) return cached;
+
+  auto program = build_program(lexer::tokenizer(source), opts);
+  cache::save(program, key, file); // best effort, a read only dir just means no cache
+  return program;
 }
 
-void repl(symtable::environment* env) {
+void execute_and_print(parser::program& program, symtable::environment* env, const run_options& opts,
+                       std::ostream& out = std::cout, std::ostream& diag = std::cerr) {
+  resolver::resolve(program, env);
+
+  jit::code_cache native; // owns the code binary_exp::native points at
+  if(opts.jit && opts.exec == engine::TREE) native.compile(program);
+
+  interpreter::value ret;
+  switch(opts.exec) {
+    case engine::TREE:    ret = interpreter::eval_program(&program, env); break;
+    case engine::VM:      ret = vm::eval_program(&program, env); break;
+    case engine::CLOSURE: ret = closure::eval_program(&program, env); break;
+  }
+  print_value(ret, out);
+  out << std::endl;
+  if(opts.stats) interpreter::dump_feedback(program, diag);
+}
+
+void repl(symtable::environment* env, const run_options& opts) {
   std::cout << "Meow REPL - Enter expressions (Ctrl+C to exit)\n";
   
   while(true) {
@@ -54,14 +128,10 @@ void repl(symtable::environment* env) {
     }
     
     try {
-      auto tokens = lexer::new_tokenizer_runtime(input); 
-      lexer::scan_tokens(tokens);
-      // tokens.dump_tokens(); 
-      parser::parse parsed(tokens.tokens);
-      auto program = parsed.make_ast();
+      auto program = build_program(lexer::new_tokenizer_runtime(input), opts);
       // utils::dump_program(program);
       
-      execute_and_print(program, env);
+      execute_and_print(program, env, opts);
       
     } catch(const std::exception& e) {
       std::cerr << "Error: " << e.what() << std::endl;
@@ -69,16 +139,13 @@ void repl(symtable::environment* env) {
   }
 }
 
-void execute_file(const char* filepath, symtable::environment* env) {
+void execute_file(symtable::environment* env, const run_options& opts) {
   try {
-    auto tokens = lexer::tokenize_file(filepath);
-    
-    parser::parse parsed(tokens);
-    auto program = parsed.make_ast();
+    auto program = opts.cache ? load_cached(opts) : build_program(lexer::new_tokenizer(opts.file, opts.load), opts);
     
     // utils::dump_program(program);
     
-    execute_and_print(program, env);
+    execute_and_print(program, env, opts);
     
   } catch(const std::exception& e) {
     std::cerr << "Error executing file: " << e.what() << std::endl;
@@ -86,37 +153,152 @@ void execute_file(const char* filepath, symtable::environment* env) {
   }
 }
 
+// one --batch script in its own copy of the globals, output kept for later
+struct script_result {
+  std::string output;
+  bool failed = false;
+  bool done = false;
+};
+
+void run_script(const std::string& path, const symtable::environment& globals, const run_options& opts,
+                script_result& result) {
+  symtable::run_symbols symbols; // this script's names go when it's done
+  std::ostringstream out;
+  run_options script_opts = opts;
+  script_opts.file = path.c_str();
+  try {
+    auto program = opts.cache ? load_cached(script_opts) : build_program(lexer::new_tokenizer(path, opts.load), opts);
+    auto env = globals.clone();
+    execute_and_print(program, env.get(), opts, out, out);
+  } catch(const std::exception& e) {
+    out << "Error executing file: " << e.what() << std::endl;
+    result.failed = true;
+  }
+  result.output = out.str();
+}
+
+/*
+ * --batch: every script on a pool of --jobs workers, one process total
+ * globals is only ever cloned, never run in, so the workers share it as is
+ * each script's output is printed under a "== path" line in input order,
+ * as soon as it and everything before it finished
+ * */
+int run_batch(const symtable::environment& globals, const run_options& opts) {
+  std::vector<std::string> paths = opts.batch_files;
+  if(paths.empty()) {
+    for(std::string line; std::getline(std::cin, line);) {
+      if(!line.empty()) paths.push_back(line);
+    }
+  }
+
+  std::vector<script_result> results(paths.size());
+  std::mutex printing;
+  size_t printed = 0, failed = 0;
+
+  utils::thread_pool pool(opts.jobs);
+  pool.for_each(paths.size(), [&](size_t i) {
+    run_script(paths[i], globals, opts, results[i]);
+
+    std::lock_guard lock(printing);
+    results[i].done = true;
+    for(; printed < results.size() && results[printed].done; printed++) {
+      std::cout << "== " << paths[printed] << "\n" << results[printed].output;
+      failed += results[printed].failed;
+      results[printed].output = std::string(); // printed, let it go
+    }
+  });
+  std::cout.flush();
+
+  if(failed) std::cerr << failed << " of " << paths.size() << " scripts failed\n";
+  return failed ? 1 : 0;
+}
+
 symtable::environment* create_global_env() {
   auto env = new symtable::environment(nullptr);
   
-  env->declare_variable("true", new interpreter::bool_val(true));
-  env->declare_variable("false", new interpreter::bool_val(false));
-  env->declare_variable("nil", new interpreter::nil_val());
+  env->declare_variable(symtable::intern("true"), interpreter::make_bool(true));
+  env->declare_variable(symtable::intern("false"), interpreter::make_bool(false));
   
   return env;
 }
 
+void usage(const char* prog) {
+  std::cerr << "Usage: " << prog << " [options] [filename]\n";
+  std::cerr << "  No arguments: Start REPL\n";
+  std::cerr << "  With filename: Execute file\n";
+  std::cerr << "  --batch [filenames]: Execute many files, each with fresh globals\n";
+  std::cerr << "Options:\n";
+  std::cerr << "  --load=read|mmap|stream  how the file is loaded (default read)\n";
+  std::cerr << "  --no-opt                 skip constant folding before eval\n";
+  std::cerr << "  --engine=tree|vm|closure tree walker, bytecode vm or closure tree (default tree)\n";
+  std::cerr << "  --jit                    native code for numeric expressions (tree engine, x86-64 linux)\n";
+  std::cerr << "  --stats                  print operator cache hit/miss counts (tree engine)\n";
+  std::cerr << "  --cache                  reuse the parsed program from <script>.meowc when the source is unchanged\n";
+  std::cerr << "  --cache-dir=DIR          like --cache, cache files go in DIR\n";
+  std::cerr << "  --parse-threads=N        lex and parse on N threads (default 1)\n";
+  std::cerr << "  --batch                  run every filename (or each path read from stdin) in one process\n";
+  std::cerr << "  --jobs=N                 --batch worker threads (default: one per core)\n";
+}
+
+bool parse_args(int argc, char** argv, run_options& opts) {
+  for(int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+
+    if(arg == "--load=read") opts.load = lexer::load_mode::READ;
+    else if(arg == "--load=mmap") opts.load = lexer::load_mode::MMAP;
+    else if(arg == "--load=stream") opts.load = lexer::load_mode::STREAM;
+    else if(arg == "--no-opt") opts.optimize = false;
+    else if(arg == "--engine=tree") opts.exec = engine::TREE;
+    else if(arg == "--engine=vm") opts.exec = engine::VM;
+    else if(arg == "--engine=closure") opts.exec = engine::CLOSURE;
+    else if(arg == "--jit") opts.jit = true;
+    else if(arg == "--stats") opts.stats = true;
+    else if(arg == "--cache") opts.cache = true;
+    else if(arg.rfind("--cache-dir=", 0) == 0) {
+      opts.cache = true;
+      opts.cache_dir = arg.substr(12);
+    }
+    else if(arg.rfind("--parse-threads=", 0) == 0) {
+      opts.parse_threads = std::strtoul(arg.c_str() + 16, nullptr, 10);
+      if(opts.parse_threads == 0) return false;
+    }
+    else if(arg == "--batch") opts.batch = true;
+    else if(arg.rfind("--jobs=", 0) == 0) {
+      opts.jobs = std::strtoul(arg.c_str() + 7, nullptr, 10);
+      if(opts.jobs == 0) return false;
+    }
+    else if(arg.rfind("--", 0) == 0) return false; // unknown flag
+    else opts.batch_files.push_back(arg);
+  }
+
+  if(opts.batch) return true;
+  if(opts.batch_files.size() > 1) return false; // second file
+  if(!opts.batch_files.empty()) opts.file = opts.batch_files[0].c_str();
+  return true;
+}
+
 int main(int argc, char** argv) {
-  system("clear");
+  run_options opts;
+  if(!parse_args(argc, argv, opts)) {
+    usage(argv[0]);
+    return 1;
+  }
+
   auto env = create_global_env();
+  int status = 0;
   
-  if(argc == 1) {
-    // no arguments - enter REPL mode
-    repl(env);
-  } 
-  else if(argc == 2) {
-    // one argument - execute file
-    execute_file(argv[1], env);
+  if(opts.batch) {
+    status = run_batch(*env, opts);
   }
+  else if(!opts.file) {
+    // no file - enter REPL mode
+    system("clear");
+    repl(env, opts);
+  } 
   else {
-    // too many arguments
-    std::cerr << "Usage: " << argv[0] << " [filename]\n";
-    std::cerr << "  No arguments: Start REPL\n";
-    std::cerr << "  With filename: Execute file\n";
-    delete env;
-    return 1;
+    execute_file(env, opts);
   }
   
   delete env;
-  return 0;
+  return status;
 }